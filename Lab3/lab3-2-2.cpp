@@ -1,35 +1,24 @@
 #include <iostream>
 #include <thread>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
-std::queue<int> buffer; // shared buffer
-
+#include <chrono>
+#include "../common/mpmc_queue.h"
 const unsigned int MAX = 5; // max buffer size
-std::mutex mtx; // mutex to protect buffer
-std::condition_variable cv; // condition variable for sync
+// shared buffer: lock-free slots, a thread only sleeps when the buffer is full or empty
+BlockingMPMCQueue<int> buffer(MAX);
 // Producer function
 void producer() {
 for (int i = 1; i <= 10; i++) {
-std::unique_lock<std::mutex> lock(mtx); // lock buffer
-cv.wait(lock, [] { return buffer.size() < MAX; }); // wait if buffer full
-buffer.push(i); // produce item
+buffer.push(i); // produce item, waits if buffer full
 std::cout << "Produced: " << i << "\n";
-cv.notify_all(); // notify consumers
-lock.unlock();
 std::this_thread::sleep_for(std::chrono::milliseconds(100)); // simulate production time
 }
 }
 // Consumer function
 void consumer() {
 for (int i = 1; i <= 10; i++) {
-std::unique_lock<std::mutex> lock(mtx); // lock buffer
-cv.wait(lock, [] { return !buffer.empty(); }); // wait if buffer empty
-int item = buffer.front(); // consume item
-buffer.pop();
+int item = 0;
+buffer.pop(item); // consume item, waits if buffer empty
 std::cout << "Consumed: " << item << "\n";
-cv.notify_all(); // notify producer
-lock.unlock();
 std::this_thread::sleep_for(std::chrono::milliseconds(150)); // simulate consumption time
 }
 }
@@ -1,29 +1,89 @@
 #include <iostream>
 #include <thread>
 #include <shared_mutex>
-std::shared_mutex rwLock; // allows multiple readers or single writer
+#include <mutex>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+#include "../common/rw_lock.h"
+ReaderBiasedRWLock rwLock; // allows multiple readers or single writer, readers don't share a counter
 int sharedData = 0; // shared data
 // Reader function
 void reader(int id) {
 for (int i = 0; i < 3; i++) {
-rwLock.lock_shared(); // shared lock allows multiple readers
+{
+std::shared_lock<ReaderBiasedRWLock> lock(rwLock); // shared lock allows multiple readers
 std::cout << "Reader " << id << " read data = " << sharedData << "\n";
-rwLock.unlock_shared();
+}
 std::this_thread::sleep_for(std::chrono::milliseconds(200));
 }
 }
 // Writer function
 void writer(int id) {
 for (int i = 0; i < 3; i++) {
-rwLock.lock(); // exclusive lock for writing
+{
+std::unique_lock<ReaderBiasedRWLock> lock(rwLock); // exclusive lock, new readers wait until it is released
 sharedData += 10;
 std::cout << "Writer " << id << " updated data = " << sharedData << "\n";
-rwLock.unlock();
+}
 std::this_thread::sleep_for(std::chrono::milliseconds(300));
 }
 
 }
-int main() {
+// Each thread does 'ops' operations, every 100th one a write of sharedData += 10
+template <typename Read, typename Write>
+double measure(int threads, long ops, Read read, Write write) {
+std::atomic<bool> go(false);
+std::atomic<long> checksum(0);
+std::vector<std::thread> pool;
+for (int t = 0; t < threads; t++) {
+pool.emplace_back([&, t]{
+long seen = 0;
+while (!go) std::this_thread::yield();
+for (long i = 0; i < ops; i++) {
+if ((i + t) % 100 == 0) write();
+else seen += read();
+}
+checksum += seen;
+});
+}
+auto start = std::chrono::steady_clock::now();
+go = true;
+for (auto& th : pool) th.join();
+double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+return threads * ops / seconds / 1e6;
+}
+void benchmark(long ops) {
+std::cout << "99% reads, " << ops << " ops per thread (" << std::thread::hardware_concurrency() << " hardware threads), Mops/s\n";
+unsigned max_threads = std::max(8u, 2 * std::thread::hardware_concurrency());
+for (int threads = 1; threads <= (int)max_threads; threads *= 2) {
+std::shared_mutex shared;
+int plain = 0;
+double std_rate = measure(threads, ops,
+[&]{ std::shared_lock<std::shared_mutex> lock(shared); return plain; },
+[&]{ std::unique_lock<std::shared_mutex> lock(shared); plain += 10; });
+ReaderBiasedRWLock biased;
+int guarded = 0;
+double biased_rate = measure(threads, ops,
+[&]{ std::shared_lock<ReaderBiasedRWLock> lock(biased); return guarded; },
+[&]{ std::unique_lock<ReaderBiasedRWLock> lock(biased); guarded += 10; });
+SeqLock<int> sequenced(0);
+double seq_rate = measure(threads, ops,
+[&]{ return sequenced.load(); },
+[&]{ sequenced.update([](int& value){ value += 10; }); });
+std::cout << "  " << threads << " threads: std::shared_mutex " << std_rate
+<< ", reader-biased " << biased_rate << ", seqlock " << seq_rate << "\n";
+}
+}
+int main(int argc, char* argv[]) {
+if (argc >= 2 && std::string(argv[1]) == "--bench") {
+benchmark(argc >= 3 ? std::max(1L, std::atol(argv[2])) : 2000000L);
+return 0;
+}
 std::thread r1(reader, 1), r2(reader, 2), w1(writer, 1);
 r1.join(); r2.join(); w1.join();
 }
+// Compile: g++ -O2 -std=c++17 -pthread lab3-2-3.cpp -o lab3-2-3
+// Benchmark against std::shared_mutex at 99% reads: ./lab3-2-3 --bench [OPS_PER_THREAD]
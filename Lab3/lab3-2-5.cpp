@@ -6,40 +6,105 @@
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <cstdlib>
+#include "../common/thread_pool.h"
+// Previous design, kept for the benchmark: one global queue of std::function behind one mutex
+class GlobalQueuePool {
 std::queue<std::function<void()>> tasks; // task queue
 std::mutex mtx; // mutex for queue
 std::condition_variable cv; // condition variable
-std::atomic<bool> done(false); // flag to stop threads
-// Worker thread function
-void worker(int id) {
+std::atomic<bool> done{false}; // flag to stop threads
+std::vector<std::thread> pool;
+void worker() {
 while (!done) {
 std::function<void()> task;
 {
 std::unique_lock<std::mutex> lock(mtx);
-
-cv.wait(lock, []{ return !tasks.empty() || done; }); // wait for task
+cv.wait(lock, [this]{ return !tasks.empty() || done; }); // wait for task
 if (done && tasks.empty()) break;
-task = tasks.front();
+task = tasks.front(); // copies the std::function
 tasks.pop();
 }
-std::cout << "Worker " << id << " executing task\n";
 task();
 }
 }
-int main() {
-const int THREADS = 3;
-std::vector<std::thread> pool;
-// create worker threads
-for (int i = 0; i < THREADS; i++)
-pool.emplace_back(worker, i+1);
-// add tasks to the queue
-for (int i = 1; i <= 6; i++) {
-std::lock_guard<std::mutex> lock(mtx);
-tasks.push([i]{ std::cout << "Task " << i << " done\n"; });
-cv.notify_one(); // wake a worker
+public:
+explicit GlobalQueuePool(size_t threads) {
+for (size_t i = 0; i < threads; i++) pool.emplace_back(&GlobalQueuePool::worker, this);
 }
-std::this_thread::sleep_for(std::chrono::seconds(1));
+~GlobalQueuePool() {
 done = true; // signal threads to exit
 cv.notify_all(); // wake all workers
 for (auto& t : pool) t.join();
 }
+void post(std::function<void()> task) {
+std::lock_guard<std::mutex> lock(mtx);
+tasks.push(std::move(task));
+cv.notify_one(); // wake a worker
+}
+};
+// Time 'total' tiny tasks. With 'nested', 64 root tasks each post the rest from inside the pool.
+template <typename Pool, typename Post>
+double measure(size_t threads, long total, bool nested, Post post) {
+std::atomic<long> finished{0};
+auto start = std::chrono::steady_clock::now();
+{
+Pool pool(threads);
+auto tiny = [&finished]{ finished.fetch_add(1, std::memory_order_relaxed); };
+if (nested) {
+const long roots = 64;
+for (long r = 0; r < roots; r++) {
+long children = total / roots + (r < total % roots ? 1 : 0) - 1;
+post(pool, [&pool, &post, tiny, children]{
+for (long c = 0; c < children; c++) post(pool, tiny);
+tiny();
+});
+}
+} else {
+for (long i = 0; i < total; i++) post(pool, tiny);
+}
+while (finished.load() < total) std::this_thread::yield(); // wait until every task ran
+}
+return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+void benchmark(long total) {
+std::cout << "Tiny-task throughput, " << total << " tasks (" << std::thread::hardware_concurrency() << " hardware threads)\n";
+auto global_post = [](GlobalQueuePool& pool, auto task){ pool.post(task); };
+auto pool_post = [](ThreadPool& pool, auto task){ pool.post(task); };
+auto pool_submit = [](ThreadPool& pool, auto task){ pool.submit(task); }; // future dropped: measures its cost only
+for (bool nested : {false, true}) {
+std::cout << (nested ? "tasks spawned by tasks:\n" : "tasks submitted from main:\n");
+for (size_t threads : {1, 2, 4, 8}) {
+double old_time = measure<GlobalQueuePool>(threads, total, nested, global_post);
+double post_time = measure<ThreadPool>(threads, total, nested, pool_post);
+double submit_time = measure<ThreadPool>(threads, total, nested, pool_submit);
+std::cout << "  " << threads << " threads: global queue " << total / old_time / 1e6
+<< " M/s, work stealing post " << total / post_time / 1e6
+<< " M/s, submit+future " << total / submit_time / 1e6 << " M/s\n";
+}
+}
+}
+int main(int argc, char* argv[]) {
+if (argc >= 2 && std::string(argv[1]) == "--bench") {
+benchmark(argc >= 3 ? std::max(1L, std::atol(argv[2])) : 1000000L);
+return 0;
+}
+const int THREADS = 3;
+ThreadPool pool(THREADS); // create worker threads
+std::vector<std::future<int>> results;
+// add tasks to the pool
+for (int i = 1; i <= 6; i++) {
+results.push_back(pool.submit([i]{
+std::cout << "Task " << i << " done\n";
+return i * i;
+}));
+}
+for (int i = 1; i <= 6; i++)
+std::cout << "Task " << i << " result: " << results[i-1].get() << "\n"; // wait for each task
+pool.shutdown(); // runs anything still queued, then joins the workers
+}
+// Compile: g++ -O2 -std=c++17 -pthread lab3-2-5.cpp -o lab3-2-5
+// Benchmark against the old single-queue design: ./lab3-2-5 --bench [TASKS]
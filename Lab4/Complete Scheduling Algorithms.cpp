@@ -1,12 +1,25 @@
 // File: scheduling_algorithms.cpp
-// Compile: g++ -o scheduling_algorithms scheduling_algorithms.cpp -std=c++17
+// Compile: g++ -o scheduling_algorithms scheduling_algorithms.cpp -std=c++17 -pthread
 
 #include <iostream>
 #include <vector>
 #include <queue>
 #include <algorithm>
 #include <climits>
+#include <functional>
 #include <iomanip>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <set>
+#include <unordered_map>
+#include "../common/online_metrics.h"
 
 struct Process {
     int pid;
@@ -17,11 +30,14 @@ struct Process {
     int turnaround_time;
     int waiting_time;
     int priority;
+    int first_run_time = -1; // first dispatch; set by the streaming engines, -1 if never run
     
     Process(int id, int at, int bt, int pr = 0) 
         : pid(id), arrival_time(at), burst_time(bt), 
           remaining_time(bt), priority(pr), 
           completion_time(0), turnaround_time(0), waiting_time(0) {}
+    
+    int responseTime() const { return first_run_time < 0 ? -1 : first_run_time - arrival_time; }
 };
 
 // ProcessScheduler class to handle display and calculations
@@ -69,217 +85,1443 @@ public:
     }
 };
 
-class SchedulingAlgorithms {
+// Binary trace layout: an 8-byte header ("PTRC" + uint32 version) followed by
+// fixed-width little-endian records, one per process
+struct TraceRecord {
+    int32_t pid;
+    int32_t arrival_time;
+    int32_t burst_time;
+    int32_t priority;
+};
+static_assert(sizeof(TraceRecord) == 16, "TraceRecord must stay 16 bytes");
+
+static const char TRACE_MAGIC[4] = {'P', 'T', 'R', 'C'};
+static const uint32_t TRACE_VERSION = 1;
+
+// Streaming trace loader. Reads CSV lines "pid,arrival,burst[,priority]" or
+// binary TraceRecords through a fixed-size buffer, so memory use does not
+// depend on the length of the trace. The format is detected from the header.
+class TraceReader {
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+    
+    std::ifstream in;
+    std::vector<char> buffer;
+    size_t pos = 0;
+    size_t end = 0;
+    bool binary = false;
+    long long line_number = 0;
+    long long records_read = 0;
+    
+    // Move the unread tail to the front and top the buffer up from the file
+    bool fill() {
+        if (pos > 0) {
+            std::memmove(buffer.data(), buffer.data() + pos, end - pos);
+            end -= pos;
+            pos = 0;
+        }
+        if (!in) return false;
+        in.read(buffer.data() + end, BUFFER_SIZE - end);
+        size_t got = static_cast<size_t>(in.gcount());
+        end += got;
+        return got > 0;
+    }
+    
+    bool nextBinary(Process& p) {
+        if (end - pos < sizeof(TraceRecord)) {
+            fill();
+            if (end - pos < sizeof(TraceRecord)) {
+                if (end != pos) throw std::runtime_error("truncated binary trace record");
+                return false;
+            }
+        }
+        TraceRecord rec;
+        std::memcpy(&rec, buffer.data() + pos, sizeof(rec));
+        pos += sizeof(rec);
+        p = Process(rec.pid, rec.arrival_time, rec.burst_time, rec.priority);
+        return true;
+    }
+    
+    bool nextCsv(Process& p) {
+        while (true) {
+            char* line = buffer.data() + pos;
+            char* newline = static_cast<char*>(std::memchr(line, '\n', end - pos));
+            if (newline == nullptr) {
+                if (pos == 0 && end == BUFFER_SIZE) {
+                    throw std::runtime_error("trace line longer than read buffer");
+                }
+                if (fill()) continue;
+                if (pos == end) return false;
+                // Last line without a trailing newline
+                buffer[end] = '\n';
+                newline = buffer.data() + end;
+                end++;
+                line = buffer.data() + pos;
+            }
+            *newline = '\0';
+            pos = newline - buffer.data() + 1;
+            line_number++;
+            
+            // Skip blank lines, comments and a header row
+            char* c = line;
+            while (*c == ' ' || *c == '\t' || *c == '\r') c++;
+            if (*c == '\0' || *c == '#' || (line_number == 1 && (*c < '0' || *c > '9') && *c != '-')) {
+                continue;
+            }
+            
+            // 'rest' stays just past the last field that parsed, so a
+            // dangling comma or trailing junk is caught below
+            long fields[4] = {0, 0, 0, 0};
+            int count = 0;
+            char* rest = c;
+            while (count < 4) {
+                char* field_end;
+                long value = std::strtol(c, &field_end, 10);
+                if (field_end == c) break;
+                fields[count++] = value;
+                c = field_end;
+                while (*c == ' ' || *c == '\t') c++;
+                rest = c;
+                if (*c != ',') break;
+                c++;
+            }
+            while (*rest == ' ' || *rest == '\t' || *rest == '\r') rest++;
+            if (count < 3 || *rest != '\0') {
+                throw std::runtime_error("malformed trace line " + std::to_string(line_number));
+            }
+            p = Process(fields[0], fields[1], fields[2], count == 4 ? fields[3] : 0);
+            return true;
+        }
+    }
+    
 public:
-    // FCFS Scheduling
-    static void FCFS(std::vector<Process>& processes) {
-        std::sort(processes.begin(), processes.end(), 
-                  [](const Process& a, const Process& b) {
-                      return a.arrival_time < b.arrival_time;
-                  });
+    // One spare byte past BUFFER_SIZE holds a newline for an unterminated last line
+    explicit TraceReader(const std::string& path)
+        : in(path, std::ios::binary), buffer(BUFFER_SIZE + 1) {
+        if (!in) throw std::runtime_error("cannot open trace " + path);
         
-        int current_time = 0;
-        for (auto& p : processes) {
-            if (current_time < p.arrival_time) {
-                current_time = p.arrival_time;
+        fill();
+        if (end >= 8 && std::memcmp(buffer.data(), TRACE_MAGIC, 4) == 0) {
+            uint32_t version;
+            std::memcpy(&version, buffer.data() + 4, sizeof(version));
+            if (version != TRACE_VERSION) throw std::runtime_error("unsupported trace version");
+            binary = true;
+            pos = 8;
+        }
+    }
+    
+    bool next(Process& p) {
+        bool ok = binary ? nextBinary(p) : nextCsv(p);
+        if (ok) records_read++;
+        return ok;
+    }
+    
+    long long recordsRead() const { return records_read; }
+};
+
+// Writes the compact binary trace format read back by TraceReader
+class TraceWriter {
+private:
+    static constexpr size_t BATCH_RECORDS = 4096;
+    
+    std::ofstream out;
+    std::vector<TraceRecord> batch;
+    
+public:
+    explicit TraceWriter(const std::string& path) : out(path, std::ios::binary) {
+        if (!out) throw std::runtime_error("cannot create trace " + path);
+        out.write(TRACE_MAGIC, 4);
+        out.write(reinterpret_cast<const char*>(&TRACE_VERSION), sizeof(TRACE_VERSION));
+        batch.reserve(BATCH_RECORDS);
+    }
+    
+    ~TraceWriter() { flush(); }
+    
+    void write(const Process& p) {
+        batch.push_back({p.pid, p.arrival_time, p.burst_time, p.priority});
+        if (batch.size() == BATCH_RECORDS) flush();
+    }
+    
+    void flush() {
+        out.write(reinterpret_cast<const char*>(batch.data()), batch.size() * sizeof(TraceRecord));
+        batch.clear();
+        out.flush();
+    }
+};
+
+// One contiguous stretch of CPU time given to a process
+struct GanttSpan {
+    int pid;
+    int start;
+    int end;
+};
+
+// Append-only record of which process held the CPU and when. Spans live in
+// fixed-size chunks, so recording never moves earlier spans and costs one
+// store per dispatch; back-to-back spans of the same process are merged.
+class Timeline {
+private:
+    static constexpr size_t CHUNK_SPANS = 1 << 16;
+    
+    std::vector<std::unique_ptr<GanttSpan[]>> chunks;
+    size_t count = 0;
+    GanttSpan* last = nullptr;      // most recent span, for merging
+    GanttSpan* next_slot = nullptr; // where the next span is written
+    GanttSpan* chunk_end = nullptr;
+    
+    void nextChunk() {
+        size_t index = count / CHUNK_SPANS;
+        if (index == chunks.size()) {
+            chunks.emplace_back(new GanttSpan[CHUNK_SPANS]);
+        }
+        next_slot = chunks[index].get();
+        chunk_end = next_slot + CHUNK_SPANS;
+    }
+    
+public:
+    void record(int pid, int start, int end) {
+        if (end <= start) return;
+        if (last != nullptr && last->pid == pid && last->end == start) {
+            last->end = end;
+            return;
+        }
+        if (next_slot == chunk_end) nextChunk();
+        *next_slot = {pid, start, end};
+        last = next_slot++;
+        count++;
+    }
+    
+    // Allocate chunks up front so recording 'spans' spans never allocates
+    void reserve(size_t spans) {
+        while (chunks.size() * CHUNK_SPANS < spans) {
+            chunks.emplace_back(new GanttSpan[CHUNK_SPANS]);
+        }
+    }
+    
+    // Drop recorded spans but keep the chunks for the next run
+    void clear() {
+        count = 0;
+        last = next_slot = chunk_end = nullptr;
+    }
+    
+    size_t size() const { return count; }
+    
+    const GanttSpan& operator[](size_t i) const { return chunks[i / CHUNK_SPANS][i % CHUNK_SPANS]; }
+    
+    int makespan() const { return count ? (*this)[count - 1].end : 0; }
+    
+    long long busyTime() const {
+        long long busy = 0;
+        for (size_t i = 0; i < count; i++) {
+            busy += (*this)[i].end - (*this)[i].start;
+        }
+        return busy;
+    }
+    
+    // Idle time between time 0 and the last completion
+    long long idleTime() const { return makespan() - busyTime(); }
+    
+    // Number of dispatches that handed the CPU to a different process
+    int contextSwitches() const {
+        int switches = 0;
+        for (size_t i = 1; i < count; i++) {
+            if ((*this)[i].pid != (*this)[i - 1].pid) switches++;
+        }
+        return switches;
+    }
+    
+    // Response time = first time on the CPU - arrival time
+    double averageResponseTime(const std::vector<Process>& processes) const {
+        if (processes.empty()) return 0.0;
+        
+        std::unordered_map<int, int> first_start;
+        first_start.reserve(processes.size());
+        for (size_t i = 0; i < count; i++) {
+            first_start.emplace((*this)[i].pid, (*this)[i].start);
+        }
+        
+        double total = 0;
+        for (const auto& p : processes) {
+            auto it = first_start.find(p.pid);
+            total += (it != first_start.end() ? it->second : p.completion_time) - p.arrival_time;
+        }
+        return total / processes.size();
+    }
+    
+    // Chrome trace event format (chrome://tracing, Perfetto); one time unit = 1us
+    void writeChromeTrace(std::ostream& out) const {
+        out << "{\"traceEvents\":[";
+        for (size_t i = 0; i < count; i++) {
+            const GanttSpan& span = (*this)[i];
+            out << (i ? ",\n" : "\n")
+                << "{\"name\":\"P" << span.pid << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0,"
+                << "\"ts\":" << span.start << ",\"dur\":" << span.end - span.start
+                << ",\"args\":{\"pid\":" << span.pid << "}}";
+        }
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+};
+
+// Discrete-event core shared by the policies below. Arrivals are consumed
+// through a cursor over the arrival-sorted order and ready processes live in
+// a min-heap, so idle gaps and run lengths are skipped in one step instead of
+// being walked one time unit at a time.
+class SchedulingEngine {
+public:
+    // Monotonic cursor over process indices sorted by (arrival_time, index)
+    class ArrivalCursor {
+    private:
+        std::vector<int> order;
+        size_t next = 0;
+        const std::vector<Process>& processes;
+        
+    public:
+        explicit ArrivalCursor(const std::vector<Process>& procs) : processes(procs) {
+            // Pack (arrival, index) into one 64-bit key; flipping the sign bit
+            // keeps negative arrival times ordered correctly as unsigned values
+            std::vector<unsigned long long> keys(procs.size());
+            for (size_t i = 0; i < procs.size(); i++) {
+                unsigned long long at = static_cast<unsigned int>(procs[i].arrival_time) ^ 0x80000000u;
+                keys[i] = (at << 32) | static_cast<unsigned int>(i);
+            }
+            std::sort(keys.begin(), keys.end());
+            
+            order.resize(keys.size());
+            for (size_t i = 0; i < keys.size(); i++) {
+                order[i] = static_cast<int>(keys[i] & 0xFFFFFFFFu);
             }
-            p.completion_time = current_time + p.burst_time;
-            p.turnaround_time = p.completion_time - p.arrival_time;
-            p.waiting_time = p.turnaround_time - p.burst_time;
-            current_time = p.completion_time;
         }
+        
+        bool exhausted() const { return next >= order.size(); }
+        
+        int peek() const { return order[next]; }
+        
+        int nextArrivalTime() const { return processes[order[next]].arrival_time; }
+        
+        int advance() { return order[next++]; }
+        
+        // Hand every process that has arrived by 'time' to 'admit'
+        template <typename AdmitFn>
+        void admitUntil(int time, AdmitFn&& admit) {
+            while (next < order.size() && processes[order[next]].arrival_time <= time) {
+                admit(order[next++]);
+            }
+        }
+    };
+    
+    // Fixed-capacity FIFO of process indices. Round robin holds each process
+    // at most once, so a ring sized to the process count never overflows.
+    class ReadyRing {
+    private:
+        std::vector<int> slots;
+        size_t head = 0;
+        size_t count = 0;
+        
+    public:
+        explicit ReadyRing(size_t capacity) : slots(std::max<size_t>(capacity, 1)) {}
+        
+        bool empty() const { return count == 0; }
+        
+        void push(int i) {
+            size_t tail = head + count;
+            if (tail >= slots.size()) tail -= slots.size();
+            slots[tail] = i;
+            count++;
+        }
+        
+        int pop() {
+            int i = slots[head];
+            if (++head == slots.size()) head = 0;
+            count--;
+            return i;
+        }
+    };
+    
+    // (key, index) pairs; ties on key go to the lowest index like the old scans
+    using ReadyHeap = std::priority_queue<std::pair<int, int>,
+                                          std::vector<std::pair<int, int>>,
+                                          std::greater<std::pair<int, int>>>;
+    
+    static void complete(Process& p, int completion_time) {
+        p.completion_time = completion_time;
+        p.turnaround_time = p.completion_time - p.arrival_time;
+        p.waiting_time = p.turnaround_time - p.burst_time;
     }
     
-    // SJF Non-preemptive Scheduling
-    static void SJF(std::vector<Process>& processes) {
+    // Non-preemptive dispatch: always run the ready process with the smallest
+    // key to completion, jumping straight to the next arrival when idle
+    template <typename KeyFn>
+    static void runNonPreemptive(std::vector<Process>& processes, KeyFn key, Timeline* timeline = nullptr) {
         int n = processes.size();
-        std::vector<bool> completed(n, false);
+        ArrivalCursor arrivals(processes);
+        ReadyHeap ready;
         int current_time = 0;
         int completed_count = 0;
         
         while (completed_count < n) {
-            int shortest_job = -1;
-            int min_burst = INT_MAX;
-            
-            for (int i = 0; i < n; i++) {
-                if (!completed[i] && processes[i].arrival_time <= current_time) {
-                    if (processes[i].burst_time < min_burst) {
-                        min_burst = processes[i].burst_time;
-                        shortest_job = i;
-                    }
-                }
-            }
+            arrivals.admitUntil(current_time, [&](int i) {
+                ready.emplace(key(processes[i]), i);
+            });
             
-            if (shortest_job == -1) {
-                current_time++;
+            if (ready.empty()) {
+                current_time = arrivals.nextArrivalTime();
                 continue;
             }
             
-            processes[shortest_job].completion_time = current_time + processes[shortest_job].burst_time;
-            processes[shortest_job].turnaround_time = processes[shortest_job].completion_time - processes[shortest_job].arrival_time;
-            processes[shortest_job].waiting_time = processes[shortest_job].turnaround_time - processes[shortest_job].burst_time;
+            int job = ready.top().second;
+            ready.pop();
             
-            current_time = processes[shortest_job].completion_time;
-            completed[shortest_job] = true;
+            complete(processes[job], current_time + processes[job].burst_time);
+            if (timeline) timeline->record(processes[job].pid, current_time, processes[job].completion_time);
+            current_time = processes[job].completion_time;
             completed_count++;
         }
     }
     
-    // SRTF (Preemptive SJF) Scheduling
-    static void SRTF(std::vector<Process>& processes) {
+    // Preemptive shortest-remaining-time: the running process only changes
+    // at an arrival or a completion, so each step runs until the earlier of
+    // the two instead of one unit at a time
+    static void runShortestRemaining(std::vector<Process>& processes, Timeline* timeline = nullptr) {
+        int n = processes.size();
+        std::vector<int> remaining_time(n);
+        
+        for (int i = 0; i < n; i++) {
+            remaining_time[i] = processes[i].burst_time;
+        }
+        
+        ArrivalCursor arrivals(processes);
+        ReadyHeap ready;
+        int current_time = 0;
+        int completed = 0;
+        
+        while (completed < n) {
+            arrivals.admitUntil(current_time, [&](int i) {
+                ready.emplace(remaining_time[i], i);
+            });
+            
+            if (ready.empty()) {
+                current_time = arrivals.nextArrivalTime();
+                continue;
+            }
+            
+            int shortest = ready.top().second;
+            ready.pop();
+            
+            int run_until = current_time + remaining_time[shortest];
+            if (!arrivals.exhausted() && arrivals.nextArrivalTime() < run_until) {
+                run_until = arrivals.nextArrivalTime();
+            }
+            
+            remaining_time[shortest] -= run_until - current_time;
+            if (timeline) timeline->record(processes[shortest].pid, current_time, run_until);
+            current_time = run_until;
+            
+            if (remaining_time[shortest] == 0) {
+                completed++;
+                complete(processes[shortest], current_time);
+            } else {
+                ready.emplace(remaining_time[shortest], shortest);
+            }
+        }
+    }
+    
+    // Global preemptive scheduling on num_cpus identical CPUs: at every
+    // instant the num_cpus best ready processes run, ordered by shortest
+    // remaining time or, when 'deadlines' is given, earliest deadline.
+    // Waiting processes share one ready heap. Running ones are indexed twice:
+    // by finish time, whose smallest entry is the next completion, and by
+    // key, whose largest entry is the preemption target. A running process's
+    // remaining time falls with the clock, so for SRTF it is keyed by its
+    // finish time, which orders the same way. Every arrival, completion and
+    // preemption costs O(log n). Returns the number of missed deadlines.
+    static long long runMultiCorePreemptive(std::vector<Process>& processes, int num_cpus,
+                                            const std::vector<int>* deadlines = nullptr,
+                                            std::vector<Timeline>* timelines = nullptr) {
+        if (num_cpus <= 0) throw std::runtime_error("multi-core scheduling needs at least one CPU");
+        
+        int n = processes.size();
+        std::vector<int> remaining_time(n);
+        for (int i = 0; i < n; i++) {
+            remaining_time[i] = processes[i].burst_time;
+        }
+        
+        std::vector<int> running(num_cpus, -1);
+        std::vector<int> started(num_cpus, 0);
+        std::vector<int> idle_cpus;
+        for (int cpu = num_cpus - 1; cpu >= 0; cpu--) {
+            idle_cpus.push_back(cpu);
+        }
+        std::set<std::pair<int, int>> completions; // (finish time, cpu)
+        std::set<std::pair<int, int>> running_keys; // (key, cpu)
+        ReadyHeap ready;
+        
+        auto waiting_key = [&](int i) { return deadlines ? (*deadlines)[i] : remaining_time[i]; };
+        
+        // While running, remaining_time holds the value at dispatch
+        auto dispatch = [&](int cpu, int i, int now) {
+            running[cpu] = i;
+            started[cpu] = now;
+            int finish = now + remaining_time[i];
+            completions.emplace(finish, cpu);
+            running_keys.emplace(deadlines ? (*deadlines)[i] : finish, cpu);
+        };
+        
+        auto vacate = [&](int cpu, int now) {
+            int i = running[cpu];
+            int finish = started[cpu] + remaining_time[i];
+            completions.erase({finish, cpu});
+            running_keys.erase({deadlines ? (*deadlines)[i] : finish, cpu});
+            remaining_time[i] -= now - started[cpu];
+            if (timelines) (*timelines)[cpu].record(processes[i].pid, started[cpu], now);
+            running[cpu] = -1;
+            return i;
+        };
+        
+        ArrivalCursor arrivals(processes);
+        int completed = 0;
+        long long missed = 0;
+        
+        auto finish = [&](int i, int now) {
+            completed++;
+            complete(processes[i], now);
+            if (deadlines && now > (*deadlines)[i]) missed++;
+        };
+        
+        while (completed < n) {
+            int now = INT_MAX;
+            if (!arrivals.exhausted()) now = arrivals.nextArrivalTime();
+            if (!completions.empty()) now = std::min(now, completions.begin()->first);
+            
+            while (!completions.empty() && completions.begin()->first == now) {
+                int cpu = completions.begin()->second;
+                finish(vacate(cpu, now), now);
+                idle_cpus.push_back(cpu);
+            }
+            
+            arrivals.admitUntil(now, [&](int i) {
+                if (remaining_time[i] == 0) finish(i, now);
+                else ready.emplace(waiting_key(i), i);
+            });
+            
+            // Fill idle CPUs, then preempt while the best waiting process
+            // beats the worst running one
+            while (!ready.empty()) {
+                int cpu;
+                if (!idle_cpus.empty()) {
+                    cpu = idle_cpus.back();
+                    idle_cpus.pop_back();
+                } else {
+                    auto worst = std::prev(running_keys.end());
+                    int worst_key = deadlines ? worst->first : worst->first - now;
+                    if (ready.top().first >= worst_key) break;
+                    cpu = worst->second;
+                }
+                
+                int next = ready.top().second;
+                ready.pop();
+                if (running[cpu] != -1) {
+                    int preempted = vacate(cpu, now);
+                    ready.emplace(waiting_key(preempted), preempted);
+                }
+                dispatch(cpu, next, now);
+            }
+        }
+        return missed;
+    }
+    
+    // Multi-level feedback queue. Arrivals enter level 0; a process that uses
+    // up its level's allotment moves down one level, and every boost_period
+    // time units all processes return to level 0. A running process below
+    // level 0 is preempted by an arrival. Levels are intrusive FIFO lists over
+    // process indices, so a boost splices whole levels in O(levels) and
+    // allotments are reset lazily through a boost epoch.
+    static void runMultiLevelFeedback(std::vector<Process>& processes,
+                                      const std::vector<int>& quanta, int boost_period,
+                                      Timeline* timeline = nullptr) {
         int n = processes.size();
+        int levels = quanta.size();
+        if (levels == 0) throw std::runtime_error("MLFQ needs at least one level");
+        for (int q : quanta) {
+            if (q <= 0) throw std::runtime_error("MLFQ quanta must be positive");
+        }
+        if (boost_period <= 0) throw std::runtime_error("MLFQ boost period must be positive");
+        
         std::vector<int> remaining_time(n);
+        std::vector<int> allotment_used(n, 0);
+        std::vector<int> epoch(n, 0);
+        std::vector<int> next_in_level(n, -1);
+        std::vector<int> head(levels, -1);
+        std::vector<int> tail(levels, -1);
         
         for (int i = 0; i < n; i++) {
             remaining_time[i] = processes[i].burst_time;
         }
         
+        auto push_back = [&](int level, int i) {
+            next_in_level[i] = -1;
+            if (tail[level] == -1) head[level] = i;
+            else next_in_level[tail[level]] = i;
+            tail[level] = i;
+        };
+        auto push_front = [&](int level, int i) {
+            next_in_level[i] = head[level];
+            head[level] = i;
+            if (tail[level] == -1) tail[level] = i;
+        };
+        auto pop_front = [&](int level) {
+            int i = head[level];
+            head[level] = next_in_level[i];
+            if (head[level] == -1) tail[level] = -1;
+            return i;
+        };
+        
+        ArrivalCursor arrivals(processes);
         int current_time = 0;
         int completed = 0;
+        int boost_epoch = 0;
+        int next_boost = boost_period;
+        
+        auto admit = [&](int i) {
+            allotment_used[i] = 0;
+            epoch[i] = boost_epoch;
+            push_back(0, i);
+        };
         
         while (completed < n) {
-            int shortest = -1;
-            int min_remaining = INT_MAX;
-            
-            for (int i = 0; i < n; i++) {
-                if (processes[i].arrival_time <= current_time && 
-                    remaining_time[i] < min_remaining && remaining_time[i] > 0) {
-                    min_remaining = remaining_time[i];
-                    shortest = i;
+            arrivals.admitUntil(current_time, admit);
+            
+            int level = 0;
+            while (level < levels && head[level] == -1) level++;
+            
+            if (level == levels) {
+                // Idle: nothing to boost, so realign the boost clock past the gap
+                current_time = arrivals.nextArrivalTime();
+                if (next_boost <= current_time) {
+                    next_boost = (current_time / boost_period + 1) * boost_period;
                 }
+                continue;
+            }
+            
+            int current = pop_front(level);
+            if (epoch[current] != boost_epoch) {
+                allotment_used[current] = 0;
+                epoch[current] = boost_epoch;
+            }
+            
+            int stop = current_time + std::min(remaining_time[current],
+                                               quanta[level] - allotment_used[current]);
+            stop = std::min(stop, next_boost);
+            if (level > 0 && !arrivals.exhausted() && arrivals.nextArrivalTime() < stop) {
+                stop = arrivals.nextArrivalTime();
             }
             
-            if (shortest == -1) {
-                current_time++;
+            int ran = stop - current_time;
+            remaining_time[current] -= ran;
+            allotment_used[current] += ran;
+            if (timeline) timeline->record(processes[current].pid, current_time, stop);
+            current_time = stop;
+            
+            arrivals.admitUntil(current_time, admit);
+            
+            if (remaining_time[current] == 0) {
+                completed++;
+                complete(processes[current], current_time);
+            } else if (allotment_used[current] >= quanta[level]) {
+                allotment_used[current] = 0;
+                push_back(std::min(level + 1, levels - 1), current);
+            } else {
+                // Preempted mid-slice: resume first within its level
+                push_front(level, current);
+            }
+            
+            if (current_time >= next_boost) {
+                for (int l = 1; l < levels; l++) {
+                    if (head[l] == -1) continue;
+                    if (tail[0] == -1) head[0] = head[l];
+                    else next_in_level[tail[0]] = head[l];
+                    tail[0] = tail[l];
+                    head[l] = tail[l] = -1;
+                }
+                boost_epoch++;
+                while (next_boost <= current_time) next_boost += boost_period;
+            }
+        }
+    }
+    
+    // CFS-style fair scheduling. Runnable processes are ordered by virtual
+    // runtime in a balanced tree (std::set); the leftmost runs for its share
+    // of target_latency, weighted by a nice value taken from its priority,
+    // and its vruntime advances inversely to its weight. Arrivals start at
+    // the current minimum vruntime so they cannot starve the others.
+    static void runFairShare(std::vector<Process>& processes, int target_latency, int min_granularity,
+                             Timeline* timeline = nullptr) {
+        if (target_latency <= 0) throw std::runtime_error("CFS target latency must be positive");
+        if (min_granularity <= 0) throw std::runtime_error("CFS minimum granularity must be positive");
+        
+        // Linux sched_prio_to_weight, nice -20 .. 19
+        static const int NICE_TO_WEIGHT[40] = {
+            88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+            9548, 7620, 6100, 4904, 3906, 3121, 2501, 1991, 1586, 1277,
+            1024, 820, 655, 526, 423, 335, 272, 215, 172, 137,
+            110, 87, 70, 56, 45, 36, 29, 23, 18, 15
+        };
+        static const long long VRUNTIME_SCALE = 1024LL << 10;
+        
+        int n = processes.size();
+        std::vector<int> remaining_time(n);
+        std::vector<long long> vruntime(n, 0);
+        std::vector<int> weight(n);
+        
+        for (int i = 0; i < n; i++) {
+            remaining_time[i] = processes[i].burst_time;
+            int nice = std::max(-20, std::min(19, processes[i].priority));
+            weight[i] = NICE_TO_WEIGHT[nice + 20];
+        }
+        
+        std::set<std::pair<long long, int>> runqueue;
+        ArrivalCursor arrivals(processes);
+        long long total_weight = 0;
+        long long min_vruntime = 0;
+        int current_time = 0;
+        int completed = 0;
+        
+        auto admit = [&](int i) {
+            vruntime[i] = min_vruntime;
+            runqueue.emplace(vruntime[i], i);
+            total_weight += weight[i];
+        };
+        
+        while (completed < n) {
+            arrivals.admitUntil(current_time, admit);
+            
+            if (runqueue.empty()) {
+                current_time = arrivals.nextArrivalTime();
                 continue;
             }
             
-            remaining_time[shortest]--;
-            current_time++;
+            int current = runqueue.begin()->second;
+            runqueue.erase(runqueue.begin());
             
-            if (remaining_time[shortest] == 0) {
+            long long share = static_cast<long long>(target_latency) * weight[current] / total_weight;
+            int slice = static_cast<int>(std::max<long long>(min_granularity, share));
+            int ran = std::min(slice, remaining_time[current]);
+            
+            remaining_time[current] -= ran;
+            if (timeline) timeline->record(processes[current].pid, current_time, current_time + ran);
+            current_time += ran;
+            vruntime[current] += ran * VRUNTIME_SCALE / weight[current];
+            
+            min_vruntime = std::max(min_vruntime, runqueue.empty()
+                                    ? vruntime[current]
+                                    : std::min(vruntime[current], runqueue.begin()->first));
+            
+            arrivals.admitUntil(current_time, admit);
+            
+            if (remaining_time[current] == 0) {
                 completed++;
-                processes[shortest].completion_time = current_time;
-                processes[shortest].turnaround_time = processes[shortest].completion_time - processes[shortest].arrival_time;
-                processes[shortest].waiting_time = processes[shortest].turnaround_time - processes[shortest].burst_time;
+                total_weight -= weight[current];
+                complete(processes[current], current_time);
+            } else {
+                runqueue.emplace(vruntime[current], current);
             }
         }
     }
     
+    // Streaming counterpart of ArrivalCursor: pulls processes from a trace
+    // source one at a time, so only the ready set is held in memory. The
+    // source must yield processes in nondecreasing arrival order.
+    template <typename Source>
+    class StreamingArrivals {
+    private:
+        Source& source;
+        Process lookahead{0, 0, 0};
+        bool has_next = false;
+        
+        void fetch() {
+            int last_arrival = lookahead.arrival_time;
+            bool had_previous = has_next;
+            has_next = source.next(lookahead);
+            if (has_next && had_previous && lookahead.arrival_time < last_arrival) {
+                throw std::runtime_error("trace is not sorted by arrival time");
+            }
+        }
+        
+    public:
+        explicit StreamingArrivals(Source& src) : source(src) { fetch(); }
+        
+        bool exhausted() const { return !has_next; }
+        
+        const Process& peek() const { return lookahead; }
+        
+        int nextArrivalTime() const { return lookahead.arrival_time; }
+        
+        Process advance() {
+            Process p = lookahead;
+            fetch();
+            return p;
+        }
+        
+        template <typename AdmitFn>
+        void admitUntil(int time, AdmitFn&& admit) {
+            while (has_next && lookahead.arrival_time <= time) {
+                admit(advance());
+            }
+        }
+    };
+    
+    // Ready entry for streamed processes; seq is the trace position and plays
+    // the role of the index tie-break used by the in-memory heap
+    struct StreamedProcess {
+        int key;
+        long long seq;
+        Process process;
+        
+        bool operator>(const StreamedProcess& other) const {
+            return key != other.key ? key > other.key : seq > other.seq;
+        }
+    };
+    
+    using StreamedHeap = std::priority_queue<StreamedProcess,
+                                             std::vector<StreamedProcess>,
+                                             std::greater<StreamedProcess>>;
+    
+    template <typename Source, typename KeyFn, typename Sink>
+    static void streamNonPreemptive(Source& source, KeyFn key, Sink on_complete) {
+        StreamingArrivals<Source> arrivals(source);
+        StreamedHeap ready;
+        long long seq = 0;
+        int current_time = 0;
+        
+        while (true) {
+            arrivals.admitUntil(current_time, [&](const Process& p) {
+                ready.push({key(p), seq++, p});
+            });
+            
+            if (ready.empty()) {
+                if (arrivals.exhausted()) break;
+                current_time = arrivals.nextArrivalTime();
+                continue;
+            }
+            
+            Process job = ready.top().process;
+            ready.pop();
+            
+            job.first_run_time = current_time;
+            complete(job, current_time + job.burst_time);
+            current_time = job.completion_time;
+            on_complete(job);
+        }
+    }
+    
+    template <typename Source, typename Sink>
+    static void streamShortestRemaining(Source& source, Sink on_complete) {
+        StreamingArrivals<Source> arrivals(source);
+        StreamedHeap ready;
+        long long seq = 0;
+        int current_time = 0;
+        
+        while (true) {
+            arrivals.admitUntil(current_time, [&](const Process& p) {
+                ready.push({p.remaining_time, seq++, p});
+            });
+            
+            if (ready.empty()) {
+                if (arrivals.exhausted()) break;
+                current_time = arrivals.nextArrivalTime();
+                continue;
+            }
+            
+            StreamedProcess shortest = ready.top();
+            ready.pop();
+            if (shortest.process.first_run_time < 0) shortest.process.first_run_time = current_time;
+            
+            int run_until = current_time + shortest.process.remaining_time;
+            if (!arrivals.exhausted() && arrivals.nextArrivalTime() < run_until) {
+                run_until = arrivals.nextArrivalTime();
+            }
+            
+            shortest.process.remaining_time -= run_until - current_time;
+            shortest.key = shortest.process.remaining_time;
+            current_time = run_until;
+            
+            if (shortest.process.remaining_time == 0) {
+                complete(shortest.process, current_time);
+                on_complete(shortest.process);
+            } else {
+                ready.push(shortest);
+            }
+        }
+    }
+    
+    template <typename Source, typename Sink>
+    static void streamRoundRobin(Source& source, int quantum, Sink on_complete) {
+        if (quantum <= 0) throw std::runtime_error("Round Robin quantum must be positive");
+        
+        StreamingArrivals<Source> arrivals(source);
+        std::queue<Process> ready_queue;
+        int current_time = 0;
+        
+        if (!arrivals.exhausted() && arrivals.nextArrivalTime() <= current_time) {
+            ready_queue.push(arrivals.advance());
+        }
+        
+        while (!ready_queue.empty() || !arrivals.exhausted()) {
+            if (ready_queue.empty()) {
+                // Zero-burst processes never run; pass them through unchanged
+                while (!arrivals.exhausted() && arrivals.peek().remaining_time == 0) {
+                    on_complete(arrivals.advance());
+                }
+                if (arrivals.exhausted()) break;
+                current_time = arrivals.nextArrivalTime();
+                ready_queue.push(arrivals.advance());
+            }
+            
+            Process current = ready_queue.front();
+            ready_queue.pop();
+            if (current.first_run_time < 0) current.first_run_time = current_time;
+            
+            int exec_time = std::min(quantum, current.remaining_time);
+            current.remaining_time -= exec_time;
+            current_time += exec_time;
+            
+            arrivals.admitUntil(current_time, [&](const Process& p) {
+                if (p.remaining_time > 0) {
+                    ready_queue.push(p);
+                } else {
+                    on_complete(p);
+                }
+            });
+            
+            if (current.remaining_time == 0) {
+                complete(current, current_time);
+                on_complete(current);
+            } else {
+                ready_queue.push(current);
+            }
+        }
+    }
+};
+
+class SchedulingAlgorithms {
+public:
+    // In-memory policies take an optional Timeline that records every
+    // dispatch; passing nullptr skips recording entirely.
+    
+    // FCFS Scheduling
+    static void FCFS(std::vector<Process>& processes, Timeline* timeline = nullptr) {
+        std::sort(processes.begin(), processes.end(), 
+                  [](const Process& a, const Process& b) {
+                      return a.arrival_time < b.arrival_time;
+                  });
+        
+        SchedulingEngine::runNonPreemptive(processes,
+            [](const Process& p) { return p.arrival_time; }, timeline);
+    }
+    
+    // SJF Non-preemptive Scheduling
+    static void SJF(std::vector<Process>& processes, Timeline* timeline = nullptr) {
+        SchedulingEngine::runNonPreemptive(processes,
+            [](const Process& p) { return p.burst_time; }, timeline);
+    }
+    
+    // SRTF (Preemptive SJF) Scheduling
+    static void SRTF(std::vector<Process>& processes, Timeline* timeline = nullptr) {
+        SchedulingEngine::runShortestRemaining(processes, timeline);
+    }
+    
+    // Preemptive SRTF on num_cpus identical CPUs. 'timelines', if given,
+    // is resized to one Timeline per CPU.
+    static void MultiCoreSRTF(std::vector<Process>& processes, int num_cpus,
+                              std::vector<Timeline>* timelines = nullptr) {
+        if (timelines) timelines->resize(std::max(num_cpus, 0));
+        SchedulingEngine::runMultiCorePreemptive(processes, num_cpus, nullptr, timelines);
+    }
+    
+    // Preemptive EDF on num_cpus identical CPUs. Process carries no deadline,
+    // so 'deadline' maps each process to its absolute deadline. Returns the
+    // number of processes that completed after their deadline.
+    template <typename DeadlineFn>
+    static long long MultiCoreEDF(std::vector<Process>& processes, int num_cpus, DeadlineFn deadline,
+                                  std::vector<Timeline>* timelines = nullptr) {
+        std::vector<int> deadlines;
+        deadlines.reserve(processes.size());
+        for (const auto& p : processes) {
+            deadlines.push_back(deadline(p));
+        }
+        if (timelines) timelines->resize(std::max(num_cpus, 0));
+        return SchedulingEngine::runMultiCorePreemptive(processes, num_cpus, &deadlines, timelines);
+    }
+    
     // Round Robin Scheduling
-    static void RoundRobin(std::vector<Process>& processes, int quantum) {
-        std::queue<int> ready_queue;
+    // The timeline is reserved up front from the bursts, so recording the
+    // slices never allocates mid-run.
+    static void RoundRobin(std::vector<Process>& processes, int quantum,
+                           Timeline* timeline = nullptr) {
+        if (quantum <= 0) throw std::runtime_error("Round Robin quantum must be positive");
+        
+        SchedulingEngine::ReadyRing ready_queue(processes.size());
         std::vector<int> remaining_time(processes.size());
-        std::vector<bool> in_queue(processes.size(), false);
         
         for (size_t i = 0; i < processes.size(); i++) {
             remaining_time[i] = processes[i].burst_time;
         }
         
+        if (timeline) {
+            size_t slices = 0;
+            for (const auto& p : processes) {
+                if (p.burst_time > 0) slices += (p.burst_time + quantum - 1) / quantum;
+            }
+            timeline->reserve(timeline->size() + slices);
+        }
+        
         int current_time = 0;
         int completed = 0;
         
-        // Sort by arrival time for initial processing
-        std::vector<int> arrival_order(processes.size());
-        for (size_t i = 0; i < processes.size(); i++) {
-            arrival_order[i] = i;
-        }
-        std::sort(arrival_order.begin(), arrival_order.end(),
-                  [&processes](int a, int b) {
-                      return processes[a].arrival_time < processes[b].arrival_time;
-                  });
+        // Arrivals are admitted in arrival order through a cursor
+        SchedulingEngine::ArrivalCursor arrivals(processes);
         
         // Add first process if available
-        if (!processes.empty() && processes[arrival_order[0]].arrival_time <= current_time) {
-            ready_queue.push(arrival_order[0]);
-            in_queue[arrival_order[0]] = true;
+        if (!arrivals.exhausted() && arrivals.nextArrivalTime() <= current_time) {
+            ready_queue.push(arrivals.advance());
         }
         
         while (!ready_queue.empty() || completed < (int)processes.size()) {
             if (ready_queue.empty()) {
-                // Find next arriving process
-                for (int idx : arrival_order) {
-                    if (remaining_time[idx] > 0 && processes[idx].arrival_time > current_time) {
-                        current_time = processes[idx].arrival_time;
-                        ready_queue.push(idx);
-                        in_queue[idx] = true;
-                        break;
-                    }
+                // Jump to the next arriving process, skipping zero-burst entries
+                while (!arrivals.exhausted() && remaining_time[arrivals.peek()] == 0) {
+                    arrivals.advance();
                 }
-                if (ready_queue.empty()) break; // No more processes
+                if (arrivals.exhausted()) break; // No more processes
+                current_time = arrivals.nextArrivalTime();
+                ready_queue.push(arrivals.advance());
             }
             
-            int current_process = ready_queue.front();
-            ready_queue.pop();
-            in_queue[current_process] = false;
+            int current_process = ready_queue.pop();
             
             int exec_time = std::min(quantum, remaining_time[current_process]);
             remaining_time[current_process] -= exec_time;
+            if (timeline) {
+                timeline->record(processes[current_process].pid, current_time, current_time + exec_time);
+            }
             current_time += exec_time;
             
             // Add newly arrived processes
-            for (int idx : arrival_order) {
-                if (!in_queue[idx] && remaining_time[idx] > 0 && 
-                    processes[idx].arrival_time <= current_time && idx != current_process) {
+            arrivals.admitUntil(current_time, [&](int idx) {
+                if (remaining_time[idx] > 0) {
                     ready_queue.push(idx);
-                    in_queue[idx] = true;
                 }
-            }
+            });
             
             if (remaining_time[current_process] == 0) {
                 completed++;
-                processes[current_process].completion_time = current_time;
-                processes[current_process].turnaround_time = 
-                    processes[current_process].completion_time - processes[current_process].arrival_time;
-                processes[current_process].waiting_time = 
-                    processes[current_process].turnaround_time - processes[current_process].burst_time;
+                SchedulingEngine::complete(processes[current_process], current_time);
             } else {
                 ready_queue.push(current_process);
-                in_queue[current_process] = true;
             }
         }
     }
     
     // Priority Scheduling (Non-preemptive)
-    static void PriorityScheduling(std::vector<Process>& processes) {
-        int n = processes.size();
-        std::vector<bool> completed(n, false);
-        int current_time = 0;
-        int completed_count = 0;
-        
-        while (completed_count < n) {
-            int highest_priority_job = -1;
-            int highest_priority = INT_MAX; // Lower number = higher priority
-            
-            for (int i = 0; i < n; i++) {
-                if (!completed[i] && processes[i].arrival_time <= current_time) {
-                    if (processes[i].priority < highest_priority) {
-                        highest_priority = processes[i].priority;
-                        highest_priority_job = i;
-                    }
-                }
+    static void PriorityScheduling(std::vector<Process>& processes, Timeline* timeline = nullptr) {
+        // Lower number = higher priority
+        SchedulingEngine::runNonPreemptive(processes,
+            [](const Process& p) { return p.priority; }, timeline);
+    }
+    
+    // Multi-Level Feedback Queue with periodic priority boost
+    static void MLFQ(std::vector<Process>& processes,
+                     const std::vector<int>& quanta = {2, 4, 8}, int boost_period = 50,
+                     Timeline* timeline = nullptr) {
+        SchedulingEngine::runMultiLevelFeedback(processes, quanta, boost_period, timeline);
+    }
+    
+    // CFS-style fair scheduling on virtual runtime (priority is used as nice)
+    static void CFS(std::vector<Process>& processes, int target_latency = 6, int min_granularity = 1,
+                    Timeline* timeline = nullptr) {
+        SchedulingEngine::runFairShare(processes, target_latency, min_granularity, timeline);
+    }
+    
+    // Streaming replay: processes are pulled from 'trace' (anything with
+    // bool next(Process&), e.g. TraceReader) in arrival order and handed to
+    // 'on_complete' as they finish
+    template <typename Source, typename Sink>
+    static void FCFS(Source& trace, Sink on_complete) {
+        SchedulingEngine::streamNonPreemptive(trace,
+            [](const Process& p) { return p.arrival_time; }, on_complete);
+    }
+    
+    template <typename Source, typename Sink>
+    static void SJF(Source& trace, Sink on_complete) {
+        SchedulingEngine::streamNonPreemptive(trace,
+            [](const Process& p) { return p.burst_time; }, on_complete);
+    }
+    
+    template <typename Source, typename Sink>
+    static void SRTF(Source& trace, Sink on_complete) {
+        SchedulingEngine::streamShortestRemaining(trace, on_complete);
+    }
+    
+    template <typename Source, typename Sink>
+    static void RoundRobin(Source& trace, int quantum, Sink on_complete) {
+        SchedulingEngine::streamRoundRobin(trace, quantum, on_complete);
+    }
+    
+    template <typename Source, typename Sink>
+    static void PriorityScheduling(Source& trace, Sink on_complete) {
+        SchedulingEngine::streamNonPreemptive(trace,
+            [](const Process& p) { return p.priority; }, on_complete);
+    }
+    
+    enum Policy { POLICY_FCFS, POLICY_SJF, POLICY_SRTF, POLICY_RR, POLICY_PRIORITY };
+    
+    static const char* policyName(Policy policy) {
+        switch (policy) {
+            case POLICY_FCFS: return "fcfs";
+            case POLICY_SJF: return "sjf";
+            case POLICY_SRTF: return "srtf";
+            case POLICY_RR: return "rr";
+            case POLICY_PRIORITY: return "priority";
+        }
+        return "unknown";
+    }
+    
+    static Policy parsePolicy(const std::string& name) {
+        for (Policy policy : {POLICY_FCFS, POLICY_SJF, POLICY_SRTF, POLICY_RR, POLICY_PRIORITY}) {
+            if (name == policyName(policy)) return policy;
+        }
+        throw std::runtime_error("unknown policy " + name);
+    }
+    
+    // Streaming replay through a policy chosen at run time
+    template <typename Source, typename Sink>
+    static void run(Policy policy, Source& trace, int quantum, Sink on_complete) {
+        switch (policy) {
+            case POLICY_FCFS: FCFS(trace, on_complete); break;
+            case POLICY_SJF: SJF(trace, on_complete); break;
+            case POLICY_SRTF: SRTF(trace, on_complete); break;
+            case POLICY_RR: RoundRobin(trace, quantum, on_complete); break;
+            case POLICY_PRIORITY: PriorityScheduling(trace, on_complete); break;
+        }
+    }
+};
+
+// Read-only cursor over an in-memory trace, usable wherever a TraceReader is
+class TraceView {
+private:
+    const std::vector<Process>& processes;
+    size_t next_index = 0;
+    
+public:
+    explicit TraceView(const std::vector<Process>& procs) : processes(procs) {}
+    
+    bool next(Process& p) {
+        if (next_index >= processes.size()) return false;
+        p = processes[next_index++];
+        return true;
+    }
+};
+
+// Fans (policy, quantum, trace) jobs out over a pool of worker threads.
+// Traces are shared read-only between jobs: each job replays its trace
+// through the streaming engine, so only its own ready set is private and
+// the input is never copied per job.
+class PolicySweep {
+public:
+    struct Job {
+        SchedulingAlgorithms::Policy policy;
+        int quantum;
+        size_t trace;
+    };
+    
+    struct Result {
+        Job job;
+        MetricsAccumulator::Snapshot summary;
+        double seconds;
+    };
+    
+private:
+    std::vector<std::shared_ptr<const std::vector<Process>>> traces;
+    std::vector<Job> jobs;
+    
+public:
+    // Takes ownership of a trace and sorts it by arrival time once, up front
+    size_t addTrace(std::vector<Process> processes) {
+        std::stable_sort(processes.begin(), processes.end(),
+                         [](const Process& a, const Process& b) {
+                             return a.arrival_time < b.arrival_time;
+                         });
+        traces.push_back(std::make_shared<const std::vector<Process>>(std::move(processes)));
+        return traces.size() - 1;
+    }
+    
+    void addJob(SchedulingAlgorithms::Policy policy, int quantum, size_t trace) {
+        if (trace >= traces.size()) throw std::runtime_error("sweep job refers to unknown trace");
+        // Checked here too, so a bad quantum fails before the worker threads start
+        if (policy == SchedulingAlgorithms::POLICY_RR && quantum <= 0) {
+            throw std::runtime_error("Round Robin quantum must be positive");
+        }
+        jobs.push_back({policy, quantum, trace});
+    }
+    
+    // Every non-RR policy once plus RR at each quantum, for every trace
+    void addStandardJobs(const std::vector<int>& quanta) {
+        for (size_t t = 0; t < traces.size(); t++) {
+            addJob(SchedulingAlgorithms::POLICY_FCFS, 0, t);
+            addJob(SchedulingAlgorithms::POLICY_SJF, 0, t);
+            addJob(SchedulingAlgorithms::POLICY_SRTF, 0, t);
+            addJob(SchedulingAlgorithms::POLICY_PRIORITY, 0, t);
+            for (int q : quanta) {
+                addJob(SchedulingAlgorithms::POLICY_RR, q, t);
             }
-            
-            if (highest_priority_job == -1) {
-                current_time++;
-                continue;
+        }
+    }
+    
+    // Results come back in job order regardless of which worker ran them
+    std::vector<Result> run(unsigned num_threads = std::thread::hardware_concurrency()) const {
+        std::vector<Result> results(jobs.size());
+        std::atomic<size_t> next_job{0};
+        
+        auto worker = [&]() {
+            size_t j;
+            while ((j = next_job.fetch_add(1)) < jobs.size()) {
+                const Job& job = jobs[j];
+                auto start = std::chrono::steady_clock::now();
+                
+                TraceView view(*traces[job.trace]);
+                MetricsAccumulator metrics;
+                SchedulingAlgorithms::run(job.policy, view, job.quantum,
+                    [&metrics](const Process& p) { metrics.add(p, p.responseTime()); });
+                
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                results[j] = {job, metrics.snapshot(), elapsed.count()};
             }
-            
-            processes[highest_priority_job].completion_time = current_time + processes[highest_priority_job].burst_time;
-            processes[highest_priority_job].turnaround_time = 
-                processes[highest_priority_job].completion_time - processes[highest_priority_job].arrival_time;
-            processes[highest_priority_job].waiting_time = 
-                processes[highest_priority_job].turnaround_time - processes[highest_priority_job].burst_time;
-            
-            current_time = processes[highest_priority_job].completion_time;
-            completed[highest_priority_job] = true;
-            completed_count++;
+        };
+        
+        num_threads = std::max(1u, std::min<unsigned>(num_threads, jobs.size()));
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < num_threads; i++) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto& t : pool) {
+            t.join();
+        }
+        return results;
+    }
+    
+    static void displayResults(const std::vector<Result>& results) {
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << std::setw(6) << "Trace"
+                  << std::setw(10) << "Policy"
+                  << std::setw(9) << "Quantum"
+                  << std::setw(14) << "Avg Waiting"
+                  << std::setw(16) << "Avg Turnaround"
+                  << std::setw(12) << "Makespan"
+                  << std::setw(10) << "Time(s)" << "\n";
+        std::cout << std::string(77, '-') << "\n";
+        
+        for (const auto& r : results) {
+            std::cout << std::setw(6) << r.job.trace
+                      << std::setw(10) << SchedulingAlgorithms::policyName(r.job.policy)
+                      << std::setw(9) << (r.job.policy == SchedulingAlgorithms::POLICY_RR ? std::to_string(r.job.quantum) : "-")
+                      << std::setw(14) << r.summary.waiting.mean
+                      << std::setw(16) << r.summary.turnaround.mean
+                      << std::setw(12) << r.summary.makespan
+                      << std::setw(10) << r.seconds << "\n";
         }
     }
 };
 
+// Replay a trace file through one policy and print summary metrics.
+// Completed processes are folded into the online metrics as they are
+// emitted, with the response time from their first dispatch.
+int replayTrace(const std::string& path, const std::string& policy, int quantum) {
+    TraceReader trace(path);
+    MetricsAccumulator metrics;
+    
+    SchedulingAlgorithms::run(SchedulingAlgorithms::parsePolicy(policy), trace, quantum,
+        [&metrics](const Process& p) { metrics.add(p, p.responseTime()); });
+    
+    MetricsAccumulator::Snapshot summary = metrics.snapshot();
+    std::cout << "=== " << policy << " replay of " << path << " ===\n";
+    std::cout << "Processes: " << summary.completed << "\n";
+    std::cout << "Makespan: " << summary.makespan << "\n";
+    MetricsAccumulator::display(summary);
+    return 0;
+}
+
+// Load a trace once and compare every policy plus RR at quanta 1..max_quantum
+int sweepTrace(const std::string& path, int max_quantum) {
+    TraceReader trace(path);
+    std::vector<Process> processes;
+    Process p(0, 0, 0);
+    while (trace.next(p)) {
+        processes.push_back(p);
+    }
+    
+    PolicySweep sweep;
+    sweep.addTrace(std::move(processes));
+    std::vector<int> quanta;
+    for (int q = 1; q <= max_quantum; q++) {
+        quanta.push_back(q);
+    }
+    sweep.addStandardJobs(quanta);
+    
+    auto start = std::chrono::steady_clock::now();
+    auto results = sweep.run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    
+    std::cout << "=== Policy sweep of " << path << " ===\n";
+    PolicySweep::displayResults(results);
+    std::cout << results.size() << " jobs in " << elapsed.count() << "s\n";
+    return 0;
+}
+
+// Timeline-derived metrics plus a one-line Gantt chart
+void displayTimeline(const Timeline& timeline, const std::vector<Process>& processes) {
+    std::cout << "Average Response Time: " << timeline.averageResponseTime(processes) << "\n";
+    std::cout << "Context Switches: " << timeline.contextSwitches()
+              << ", CPU Idle Time: " << timeline.idleTime() << "\n";
+    std::cout << "Gantt Chart:";
+    for (size_t i = 0; i < timeline.size(); i++) {
+        std::cout << " | P" << timeline[i].pid << " " << timeline[i].start << "-" << timeline[i].end;
+    }
+    std::cout << " |\n\n";
+}
+
+// Run an in-memory trace through one policy with a timeline and export it
+// in Chrome trace format (load the JSON in chrome://tracing or Perfetto)
+int exportTimeline(const std::string& path, const std::string& policy, int quantum,
+                   const std::string& out_path) {
+    TraceReader trace(path);
+    std::vector<Process> processes;
+    Process p(0, 0, 0);
+    while (trace.next(p)) {
+        processes.push_back(p);
+    }
+    
+    Timeline timeline;
+    if (policy == "fcfs") SchedulingAlgorithms::FCFS(processes, &timeline);
+    else if (policy == "sjf") SchedulingAlgorithms::SJF(processes, &timeline);
+    else if (policy == "srtf") SchedulingAlgorithms::SRTF(processes, &timeline);
+    else if (policy == "rr") SchedulingAlgorithms::RoundRobin(processes, quantum, &timeline);
+    else if (policy == "priority") SchedulingAlgorithms::PriorityScheduling(processes, &timeline);
+    else if (policy == "mlfq") SchedulingAlgorithms::MLFQ(processes, {2, 4, 8}, 50, &timeline);
+    else if (policy == "cfs") SchedulingAlgorithms::CFS(processes, 6, 1, &timeline);
+    else throw std::runtime_error("unknown policy " + policy);
+    
+    std::ofstream out(out_path);
+    if (!out) throw std::runtime_error("cannot create " + out_path);
+    timeline.writeChromeTrace(out);
+    
+    std::cout << "=== " << policy << " timeline of " << path << " ===\n";
+    std::cout << "Spans: " << timeline.size() << "\n";
+    std::cout << "Average Response Time: " << timeline.averageResponseTime(processes) << "\n";
+    std::cout << "Context Switches: " << timeline.contextSwitches() << "\n";
+    std::cout << "CPU Idle Time: " << timeline.idleTime() << "\n";
+    std::cout << "Wrote " << out_path << "\n";
+    return 0;
+}
+
+// Size a cluster from a trace: replay it through multi-core SRTF or EDF on
+// 1, 2, 4, ... up to max_cpus CPUs. EDF deadlines are arrival + 2 x burst.
+int sizeCluster(const std::string& path, const std::string& policy, int max_cpus) {
+    if (policy != "srtf" && policy != "edf") throw std::runtime_error("cluster policy must be srtf or edf");
+    
+    TraceReader trace(path);
+    std::vector<Process> processes;
+    Process p(0, 0, 0);
+    while (trace.next(p)) {
+        processes.push_back(p);
+    }
+    
+    std::vector<int> cpu_counts;
+    for (int cpus = 1; cpus < max_cpus; cpus *= 2) {
+        cpu_counts.push_back(cpus);
+    }
+    cpu_counts.push_back(std::max(1, max_cpus));
+    
+    std::cout << "=== " << policy << " cluster sizing of " << path << " (" << processes.size()
+              << " processes) ===\n";
+    std::cout << std::setw(6) << "CPUs" << std::setw(12) << "Makespan" << std::setw(12) << "Avg Wait"
+              << std::setw(14) << "Avg Turnaround" << std::setw(10) << "Missed" << std::setw(10) << "Time(s)"
+              << "\n";
+    for (int cpus : cpu_counts) {
+        std::vector<Process> run = processes;
+        long long missed = 0;
+        auto start = std::chrono::steady_clock::now();
+        if (policy == "srtf") {
+            SchedulingAlgorithms::MultiCoreSRTF(run, cpus);
+        } else {
+            missed = SchedulingAlgorithms::MultiCoreEDF(run, cpus,
+                [](const Process& q) { return q.arrival_time + 2 * q.burst_time; });
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        
+        MetricsAccumulator metrics;
+        for (const auto& q : run) {
+            metrics.add(q);
+        }
+        MetricsAccumulator::Snapshot summary = metrics.snapshot();
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(6) << cpus << std::setw(12) << summary.makespan
+                  << std::setw(12) << summary.waiting.mean
+                  << std::setw(14) << summary.turnaround.mean
+                  << std::setw(10) << (policy == "edf" ? std::to_string(missed) : "-")
+                  << std::setw(10) << elapsed.count() << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+    return 0;
+}
+
+// Convert any readable trace (CSV or binary) to the binary format
+int convertTrace(const std::string& in_path, const std::string& out_path) {
+    TraceReader trace(in_path);
+    TraceWriter writer(out_path);
+    Process p(0, 0, 0);
+    while (trace.next(p)) {
+        writer.write(p);
+    }
+    std::cout << "Wrote " << trace.recordsRead() << " records to " << out_path << "\n";
+    return 0;
+}
+
 // Demo main function
-int main() {
+// Usage: scheduling_algorithms                                   (built-in demo)
+//        scheduling_algorithms --trace FILE [POLICY] [QUANTUM]   (fcfs|sjf|srtf|rr|priority)
+//        scheduling_algorithms --convert IN.csv OUT.bin
+//        scheduling_algorithms --sweep FILE [MAX_QUANTUM]
+//        scheduling_algorithms --timeline FILE POLICY QUANTUM OUT.json  (also mlfq|cfs)
+//        scheduling_algorithms --cluster FILE POLICY MAX_CPUS           (srtf|edf)
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        try {
+            std::string mode = argv[1];
+            if (mode == "--trace" && argc >= 3) {
+                return replayTrace(argv[2], argc >= 4 ? argv[3] : "fcfs", argc >= 5 ? std::stoi(argv[4]) : 2);
+            }
+            if (mode == "--convert" && argc >= 4) {
+                return convertTrace(argv[2], argv[3]);
+            }
+            if (mode == "--sweep" && argc >= 3) {
+                return sweepTrace(argv[2], argc >= 4 ? std::stoi(argv[3]) : 10);
+            }
+            if (mode == "--timeline" && argc >= 6) {
+                return exportTimeline(argv[2], argv[3], std::stoi(argv[4]), argv[5]);
+            }
+            if (mode == "--cluster" && argc >= 5) {
+                return sizeCluster(argv[2], argv[3], std::stoi(argv[4]));
+            }
+            std::cerr << "Usage: " << argv[0]
+                      << " [--trace FILE [POLICY] [QUANTUM] | --convert IN OUT | --sweep FILE [MAX_QUANTUM]"
+                      << " | --timeline FILE POLICY QUANTUM OUT.json | --cluster FILE POLICY MAX_CPUS]\n";
+            return 1;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    
     // Test data pid, arrival_time, burst_time, priority
     std::vector<Process> processes = {
         Process(1, 0, 7, 2),
@@ -288,46 +1530,96 @@ int main() {
         Process(4, 5, 4, 3)
     };
     
+    ProcessScheduler scheduler;
+    Timeline timeline;
+    
     std::cout << "=== FCFS Scheduling ===\n";
     auto fcfs_processes = processes;
-    SchedulingAlgorithms::FCFS(fcfs_processes);
-    ProcessScheduler scheduler;
+    timeline.clear();
+    SchedulingAlgorithms::FCFS(fcfs_processes, &timeline);
     scheduler.processes = fcfs_processes;
     scheduler.displayProcesses();
     std::cout << "Average Waiting Time: " << scheduler.calculateAverageWaitingTime() << "\n";
-    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n\n";
+    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n";
+    displayTimeline(timeline, scheduler.processes);
     
     std::cout << "=== SJF Scheduling ===\n";
     auto sjf_processes = processes;
-    SchedulingAlgorithms::SJF(sjf_processes);
+    timeline.clear();
+    SchedulingAlgorithms::SJF(sjf_processes, &timeline);
     scheduler.processes = sjf_processes;
     scheduler.displayProcesses();
     std::cout << "Average Waiting Time: " << scheduler.calculateAverageWaitingTime() << "\n";
-    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n\n";
+    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n";
+    displayTimeline(timeline, scheduler.processes);
     
     std::cout << "=== SRTF Scheduling ===\n";
     auto srtf_processes = processes;
-    SchedulingAlgorithms::SRTF(srtf_processes);
+    timeline.clear();
+    SchedulingAlgorithms::SRTF(srtf_processes, &timeline);
     scheduler.processes = srtf_processes;
     scheduler.displayProcesses();
     std::cout << "Average Waiting Time: " << scheduler.calculateAverageWaitingTime() << "\n";
-    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n\n";
+    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n";
+    displayTimeline(timeline, scheduler.processes);
     
     std::cout << "=== Round Robin (Quantum=2) Scheduling ===\n";
     auto rr_processes = processes;
-    SchedulingAlgorithms::RoundRobin(rr_processes, 2);
+    timeline.clear();
+    SchedulingAlgorithms::RoundRobin(rr_processes, 2, &timeline);
     scheduler.processes = rr_processes;
     scheduler.displayProcesses();
     std::cout << "Average Waiting Time: " << scheduler.calculateAverageWaitingTime() << "\n";
-    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n\n";
+    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n";
+    displayTimeline(timeline, scheduler.processes);
     
     std::cout << "=== Priority Scheduling ===\n";
     auto priority_processes = processes;
-    SchedulingAlgorithms::PriorityScheduling(priority_processes);
+    timeline.clear();
+    SchedulingAlgorithms::PriorityScheduling(priority_processes, &timeline);
     scheduler.processes = priority_processes;
     scheduler.displayProcesses();
     std::cout << "Average Waiting Time: " << scheduler.calculateAverageWaitingTime() << "\n";
-    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n\n";
+    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n";
+    displayTimeline(timeline, scheduler.processes);
+    
+    std::cout << "=== MLFQ (Quanta=2,4,8 Boost=50) Scheduling ===\n";
+    auto mlfq_processes = processes;
+    timeline.clear();
+    SchedulingAlgorithms::MLFQ(mlfq_processes, {2, 4, 8}, 50, &timeline);
+    scheduler.processes = mlfq_processes;
+    scheduler.displayProcesses();
+    std::cout << "Average Waiting Time: " << scheduler.calculateAverageWaitingTime() << "\n";
+    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n";
+    displayTimeline(timeline, scheduler.processes);
+    
+    std::cout << "=== CFS (Latency=6) Scheduling ===\n";
+    auto cfs_processes = processes;
+    timeline.clear();
+    SchedulingAlgorithms::CFS(cfs_processes, 6, 1, &timeline);
+    scheduler.processes = cfs_processes;
+    scheduler.displayProcesses();
+    std::cout << "Average Waiting Time: " << scheduler.calculateAverageWaitingTime() << "\n";
+    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n";
+    displayTimeline(timeline, scheduler.processes);
+    
+    std::cout << "=== Multi-core SRTF (2 CPUs) Scheduling ===\n";
+    auto mc_processes = processes;
+    std::vector<Timeline> cpu_timelines;
+    SchedulingAlgorithms::MultiCoreSRTF(mc_processes, 2, &cpu_timelines);
+    scheduler.processes = mc_processes;
+    scheduler.displayProcesses();
+    std::cout << "Average Waiting Time: " << scheduler.calculateAverageWaitingTime() << "\n";
+    std::cout << "Average Turnaround Time: " << scheduler.calculateAverageTurnaroundTime() << "\n";
+    for (size_t cpu = 0; cpu < cpu_timelines.size(); cpu++) {
+        std::cout << "CPU " << cpu << ":";
+        for (size_t i = 0; i < cpu_timelines[cpu].size(); i++) {
+            const GanttSpan& span = cpu_timelines[cpu][i];
+            std::cout << " | P" << span.pid << " " << span.start << "-" << span.end;
+        }
+        std::cout << " |\n";
+    }
+    std::cout << "\n";
     
     return 0;
 }
@@ -13,61 +13,815 @@
 #include <algorithm>
 #include <climits>
 #include <memory>
+#include <deque>
+#include <functional>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <cctype>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "../common/spin_wait.h"
+
+// Assumed coherence granule; fields written by different threads are kept
+// this far apart so one core's writes do not invalidate another's lines
+constexpr size_t CACHE_LINE_SIZE = 64;
 
 class Task {
 public:
     int task_id;
     int burst_time;
     int preferred_cpu;
+    int memory_node; // NUMA node holding the task's data, -1 if unknown
     std::chrono::steady_clock::time_point arrival_time;
     std::chrono::steady_clock::time_point start_time;
     std::chrono::steady_clock::time_point completion_time;
     
-    Task(int id, int burst, int cpu = -1) 
-        : task_id(id), burst_time(burst), preferred_cpu(cpu) {
+    Task(int id, int burst, int cpu = -1, int node = -1) 
+        : task_id(id), burst_time(burst), preferred_cpu(cpu), memory_node(node) {
         arrival_time = std::chrono::steady_clock::now();
     }
 };
 
-class CPUCore {
+struct NodeBlock;
+
+// Queue node for a task; 'next' links nodes in a core's submission inbox.
+// Nodes from addTask() are allocated one by one; the nodes of a batch
+// submission share one NodeBlock. Either kind is freed with release().
+struct TaskNode {
+    Task task;
+    TaskNode* next = nullptr;
+    NodeBlock* block = nullptr; // shared allocation, nullptr for a lone node
+    
+    explicit TaskNode(const Task& t) : task(t) {}
+    explicit TaskNode(Task&& t) : task(std::move(t)) {}
+    
+    static void release(TaskNode* node);
+};
+
+// One allocation holding the nodes of a batch behind a live-node count.
+// The nodes end up on different cores and are released independently;
+// the last one to go frees the block.
+struct NodeBlock {
+    std::atomic<size_t> live;
+    
+    static size_t headerSize() {
+        return (sizeof(NodeBlock) + alignof(TaskNode) - 1) / alignof(TaskNode) * alignof(TaskNode);
+    }
+    
+    // Raw storage for 'count' nodes; the caller constructs each one with
+    // placement new and points its 'block' here
+    static TaskNode* allocate(size_t count, NodeBlock*& block) {
+        void* memory = ::operator new(headerSize() + count * sizeof(TaskNode));
+        block = new (memory) NodeBlock{{count}};
+        return reinterpret_cast<TaskNode*>(static_cast<char*>(memory) + headerSize());
+    }
+};
+
+inline void TaskNode::release(TaskNode* node) {
+    NodeBlock* block = node->block;
+    if (block == nullptr) {
+        delete node;
+        return;
+    }
+    node->~TaskNode();
+    if (block->live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        block->~NodeBlock();
+        ::operator delete(block);
+    }
+}
+
+// Chase-Lev work-stealing deque (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models"). The owning core pushes and pops at
+// the bottom without locks; other cores steal from the top with a CAS.
+// Arrays replaced on growth are kept until destruction because a thief may
+// still be reading from them.
+template <typename T>
+class WorkStealingDeque {
+private:
+    struct Array {
+        long capacity;
+        std::unique_ptr<std::atomic<T*>[]> slots;
+        
+        explicit Array(long cap) : capacity(cap), slots(new std::atomic<T*>[cap]) {}
+        
+        T* get(long i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(long i, T* item) { slots[i & (capacity - 1)].store(item, std::memory_order_relaxed); }
+    };
+    
+    alignas(CACHE_LINE_SIZE) std::atomic<long> top{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<long> bottom{0};
+    std::atomic<Array*> array;
+    std::vector<std::unique_ptr<Array>> arrays; // owner-only; current array is arrays.back()
+    
+public:
+    explicit WorkStealingDeque(long initial_capacity = 64) {
+        arrays.emplace_back(new Array(initial_capacity));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+    
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    
+    // Owner only
+    void push(T* item) {
+        long b = bottom.load(std::memory_order_relaxed);
+        long t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+        
+        if (b - t > a->capacity - 1) {
+            Array* bigger = new Array(a->capacity * 2);
+            for (long i = t; i < b; i++) {
+                bigger->put(i, a->get(i));
+            }
+            arrays.emplace_back(bigger);
+            array.store(bigger, std::memory_order_release);
+            a = bigger;
+        }
+        
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    
+    // Owner only; LIFO with respect to push
+    T* pop() {
+        long b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long t = top.load(std::memory_order_relaxed);
+        
+        if (t > b) {
+            // Empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        
+        T* item = a->get(b);
+        if (t == b) {
+            // Last item: race any thief for it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+    
+    // Any thread; oldest item first. Returns nullptr if empty or on a lost race.
+    T* steal() {
+        long t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long b = bottom.load(std::memory_order_acquire);
+        
+        if (t >= b) return nullptr;
+        
+        Array* a = array.load(std::memory_order_acquire);
+        T* item = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+    
+    // Approximate when other threads are active
+    long size() const {
+        long b = bottom.load(std::memory_order_relaxed);
+        long t = top.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+};
+
+// One-shot wakeup slot for a parked core. park() sleeps until unpark() has
+// delivered a token and consumes it; a token delivered first makes the next
+// park() return immediately. Sleeps on the token with spin_wait::Futex.
+class Parker {
+private:
+    std::atomic<int> token{0};
+    spin_wait::Futex futex;
+    
+public:
+    void park() {
+        while (token.exchange(0, std::memory_order_acquire) == 0) {
+            futex.wait(token, 0);
+        }
+    }
+    
+    void unpark() {
+        token.store(1, std::memory_order_release);
+        futex.wake(token, 1);
+    }
+};
+
+// Counts outstanding tasks; wait() blocks until the count drops to zero.
+// countDown() only touches the mutex when someone is actually waiting.
+class CompletionLatch {
+private:
+    std::atomic<int> count{0};
+    std::atomic<int> waiters{0};
+    std::mutex mtx;
+    std::condition_variable cv;
+    
+public:
+    void add(int n = 1) { count.fetch_add(n); }
+    
+    // Returns true when this call completed the last outstanding task
+    bool countDown(int n = 1) {
+        if (count.fetch_sub(n) != n) return false;
+        if (waiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(mtx);
+            cv.notify_all();
+        }
+        return true;
+    }
+    
+    void wait() {
+        if (count.load() == 0) return;
+        waiters++;
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this] { return count.load() == 0; });
+        waiters--;
+    }
+    
+    int pending() const { return count.load(); }
+};
+
+// Log-linear latency histogram in the spirit of HdrHistogram: values are
+// grouped by power of two and each group is split into SUB_BUCKETS linear
+// steps, bounding the relative error at 1/SUB_BUCKETS (under 1%). Values
+// above 2^VALUE_BITS are clamped. Like CoreStats it has a single writer;
+// merges and queries may run concurrently and see a slightly stale view.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int VALUE_BITS = 40; // about 12 days in microseconds
+    static constexpr int BUCKETS = (VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+    
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> counts;
+    
+    static int bucketOf(uint64_t value) {
+        value = std::min(value, (uint64_t(1) << VALUE_BITS) - 1);
+        if (value < static_cast<uint64_t>(SUB_BUCKETS)) return static_cast<int>(value);
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKETS + static_cast<int>((value >> shift) - SUB_BUCKETS);
+    }
+    
+    // Largest value that lands in the bucket
+    static uint64_t highestIn(int bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        int shift = bucket / SUB_BUCKETS - 1;
+        uint64_t sub = static_cast<uint64_t>(bucket % SUB_BUCKETS + SUB_BUCKETS);
+        return ((sub + 1) << shift) - 1;
+    }
+    
+public:
+    LatencyHistogram() : counts(new std::atomic<uint64_t>[BUCKETS]) {
+        for (int i = 0; i < BUCKETS; i++) counts[i].store(0, std::memory_order_relaxed);
+    }
+    
+    // Owner only
+    void record(uint64_t value) {
+        std::atomic<uint64_t>& slot = counts[bucketOf(value)];
+        slot.store(slot.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < BUCKETS; i++) {
+            uint64_t n = other.counts[i].load(std::memory_order_relaxed);
+            if (n != 0) counts[i].fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+    
+    uint64_t totalCount() const {
+        uint64_t total = 0;
+        for (int i = 0; i < BUCKETS; i++) total += counts[i].load(std::memory_order_relaxed);
+        return total;
+    }
+    
+    // Value at quantile q in [0, 1], reported as the top of its bucket
+    uint64_t valueAtQuantile(double q) const {
+        uint64_t total = totalCount();
+        if (total == 0) return 0;
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * total)));
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return highestIn(i);
+        }
+        return highestIn(BUCKETS - 1);
+    }
+    
+    uint64_t maxValue() const {
+        for (int i = BUCKETS - 1; i >= 0; i--) {
+            if (counts[i].load(std::memory_order_relaxed) != 0) return highestIn(i);
+        }
+        return 0;
+    }
+};
+
+// Log record kept in binary form; text is only produced by the flusher
+struct LogRecord {
+    long timestamp_ns;
+    int kind;
+    int core;
+    int task;
+    int other;  // victim or destination core, task count
+    long value; // burst, turnaround or migrated work, ms
+};
+
+// Asynchronous event log. Each thread appends to its own single-producer
+// ring without locks; a background thread drains every ring every few
+// milliseconds, orders the batch by timestamp and prints it. A full ring
+// drops the record and counts it rather than stall the core.
+class AsyncLogger {
+public:
+    enum Kind { LOG_CORE_STARTED, LOG_CORE_STOPPED, LOG_EXECUTING, LOG_COMPLETED, LOG_STOLE, LOG_MIGRATED };
+    
+private:
+    struct Ring {
+        static constexpr size_t CAPACITY = 4096;
+        std::unique_ptr<LogRecord[]> records{new LogRecord[CAPACITY]};
+        std::thread::id owner;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0}; // advanced by the flusher
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0}; // advanced by the owning thread
+        size_t cached_head = 0;                                 // owner's last view of head
+    };
+    
+    uint64_t instance_id;
+    std::ostream& out;
+    int flush_interval_ms;
+    std::mutex registry_mutex; // taken only when a thread logs for the first time
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::mutex drain_mutex;    // one consumer at a time
+    std::vector<LogRecord> batch;
+    std::atomic<long> dropped{0};
+    std::atomic<bool> running{true};
+    std::mutex flusher_mutex;
+    std::condition_variable flusher_cv;
+    std::thread flusher;
+    
+    static uint64_t nextInstanceId() {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1);
+    }
+    
+    Ring& localRing() {
+        // Keyed by instance id rather than address, so a logger reusing a
+        // freed logger's memory never sees its stale ring
+        thread_local uint64_t cached_instance = 0;
+        thread_local Ring* cached_ring = nullptr;
+        if (cached_instance == instance_id) return *cached_ring;
+        
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        Ring* ring = nullptr;
+        for (auto& r : rings) {
+            if (r->owner == std::this_thread::get_id()) ring = r.get();
+        }
+        if (ring == nullptr) {
+            rings.push_back(std::make_unique<Ring>());
+            ring = rings.back().get();
+            ring->owner = std::this_thread::get_id();
+        }
+        cached_instance = instance_id;
+        cached_ring = ring;
+        return *ring;
+    }
+    
+    void print(const LogRecord& r) {
+        switch (r.kind) {
+            case LOG_CORE_STARTED:
+                out << "CPU Core " << r.core << " scheduler started\n";
+                break;
+            case LOG_CORE_STOPPED:
+                out << "CPU Core " << r.core << " scheduler stopped\n";
+                break;
+            case LOG_EXECUTING:
+                out << "Core " << r.core << " executing Task " << r.task
+                    << " (Burst: " << r.value << "ms)\n";
+                break;
+            case LOG_COMPLETED:
+                out << "Core " << r.core << " completed Task " << r.task
+                    << " (Turnaround: " << r.value << "ms)\n";
+                break;
+            case LOG_STOLE:
+                out << "Core " << r.core << " stole task " << r.task << " from Core " << r.other << "\n";
+                break;
+            case LOG_MIGRATED:
+                out << "Load Balancer: Migrated " << r.other << " task(s) (" << r.value
+                    << "ms of work) from Core " << r.core << " to Core " << r.task << "\n";
+                break;
+        }
+    }
+    
+public:
+    explicit AsyncLogger(std::ostream& stream = std::cout, int interval_ms = 10)
+        : instance_id(nextInstanceId()), out(stream), flush_interval_ms(interval_ms) {
+        flusher = std::thread([this] {
+            std::unique_lock<std::mutex> lock(flusher_mutex);
+            while (running.load()) {
+                flusher_cv.wait_for(lock, std::chrono::milliseconds(flush_interval_ms));
+                flush();
+            }
+        });
+    }
+    
+    ~AsyncLogger() {
+        {
+            std::lock_guard<std::mutex> lock(flusher_mutex);
+            running = false;
+        }
+        flusher_cv.notify_all();
+        flusher.join();
+        flush();
+    }
+    
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+    
+    // Lock-free after the calling thread's first record
+    void log(Kind kind, int core, int task = -1, int other = -1, long value = 0) {
+        Ring& ring = localRing();
+        size_t tail = ring.tail.load(std::memory_order_relaxed);
+        if (tail - ring.cached_head >= Ring::CAPACITY) {
+            ring.cached_head = ring.head.load(std::memory_order_acquire);
+            if (tail - ring.cached_head >= Ring::CAPACITY) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        long now = static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>
+            (std::chrono::steady_clock::now().time_since_epoch()).count());
+        ring.records[tail % Ring::CAPACITY] = LogRecord{now, kind, core, task, other, value};
+        ring.tail.store(tail + 1, std::memory_order_release);
+    }
+    
+    // Print everything logged so far; safe to call from any thread
+    void flush() {
+        std::lock_guard<std::mutex> drain_lock(drain_mutex);
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            for (auto& ring : rings) {
+                size_t head = ring->head.load(std::memory_order_relaxed);
+                size_t tail = ring->tail.load(std::memory_order_acquire);
+                for (; head != tail; head++) {
+                    batch.push_back(ring->records[head % Ring::CAPACITY]);
+                }
+                ring->head.store(head, std::memory_order_release);
+            }
+        }
+        if (batch.empty()) return;
+        
+        std::stable_sort(batch.begin(), batch.end(), [](const LogRecord& a, const LogRecord& b) {
+            return a.timestamp_ns < b.timestamp_ns;
+        });
+        for (const LogRecord& record : batch) {
+            print(record);
+        }
+        out.flush();
+        batch.clear();
+    }
+    
+    long droppedRecords() const { return dropped.load(); }
+};
+
+// Per-core counters. Only the owning core writes them, so a plain
+// load+store replaces a locked read-modify-write; readers sum across cores.
+struct alignas(CACHE_LINE_SIZE) CoreStats {
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> stolen{0};   // tasks this core took from other cores
+    std::atomic<uint64_t> busy_ms{0};
+    
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+// Fields are grouped by writer: the inbox (producers), load (producers,
+// thieves and owner), owner-only state, and the park handshake each get
+// their own cache line. The class alignment keeps separately allocated
+// cores from sharing a line at the edges.
+class alignas(CACHE_LINE_SIZE) CPUCore {
 public:
     int core_id;
-    std::queue<Task> local_queue;
-    std::mutex queue_mutex;
-    std::atomic<bool> is_busy{false};
-    std::atomic<int> load{0};
+    WorkStealingDeque<TaskNode> local_queue;
+    alignas(CACHE_LINE_SIZE) std::atomic<TaskNode*> inbox{nullptr}; // lock-free stack of tasks submitted by other threads
+    alignas(CACHE_LINE_SIZE) std::atomic<int> load{0};
+    std::atomic<long> work{0}; // burst time of queued tasks, ms
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> is_busy{false};
+    std::atomic<long> run_end_ms{0}; // expected finish of the running task; 0 when idle
+    int unreported = 0; // owner only: completions not yet counted down on the latch
+    CoreStats stats;
+    LatencyHistogram wait_histogram;       // arrival to start, us
+    LatencyHistogram run_histogram;        // start to completion, us
+    LatencyHistogram turnaround_histogram; // arrival to completion, us
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> parked{false}; // set while idle; cleared by whoever claims the wakeup
+    Parker parker;
     
     CPUCore(int id) : core_id(id) {}
     
-    // Delete copy constructor and assignment operator due to mutex
+    ~CPUCore() {
+        TaskNode* node;
+        while ((node = local_queue.pop()) != nullptr) {
+            TaskNode::release(node);
+        }
+        freeList(inbox.exchange(nullptr));
+    }
+    
+    // Delete copy constructor and assignment operator due to the atomics
     CPUCore(const CPUCore&) = delete;
     CPUCore& operator=(const CPUCore&) = delete;
     
+    // Any thread: only the owner may touch the bottom of the deque, so
+    // submissions go through the inbox and are drained by the owner
     void addTask(const Task& task) {
-        std::lock_guard<std::mutex> lock(queue_mutex);
-        local_queue.push(task);
-        load++;
+        TaskNode* node = new TaskNode(task);
+        addTasks(node, node, 1, task.burst_time);
     }
     
+    // Any thread: publish a pre-linked chain of 'count' nodes with one CAS.
+    // The chain must run newest (head) to oldest (tail), like the inbox.
+    void addTasks(TaskNode* head, TaskNode* tail, int count, long work_ms) {
+        tail->next = inbox.load(std::memory_order_relaxed);
+        while (!inbox.compare_exchange_weak(tail->next, head, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+        }
+        load += count;
+        work += work_ms;
+    }
+    
+    // Owner only
     bool getTask(Task& task) {
-        std::lock_guard<std::mutex> lock(queue_mutex);
-        if (!local_queue.empty()) {
-            task = local_queue.front();
-            local_queue.pop();
+        drainInbox();
+        TaskNode* node = local_queue.pop();
+        if (node == nullptr) return false;
+        
+        task = node->task;
+        TaskNode::release(node);
+        load--;
+        work -= task.burst_time;
+        return true;
+    }
+    
+    // Any thread: take the oldest node from this core's deque. The caller
+    // owns the node; it is already removed from 'load' and 'work'.
+    TaskNode* stealNode() {
+        TaskNode* node = local_queue.steal();
+        if (node != nullptr) {
             load--;
-            return true;
+            work -= node->task.burst_time;
+        }
+        return node;
+    }
+    
+    bool stealTask(Task& task) {
+        TaskNode* node = stealNode();
+        if (node == nullptr) return false;
+        
+        task = node->task;
+        TaskNode::release(node);
+        return true;
+    }
+    
+    // Any thread: detach every task still waiting in the inbox. The caller
+    // takes ownership of the list and must account for 'load' and 'work'.
+    TaskNode* takeInbox() {
+        return inbox.exchange(nullptr, std::memory_order_acquire);
+    }
+    
+    // Any thread: detach the inbox and remove it from this core's accounting
+    TaskNode* takeInboxTasks(int& count, long& work_ms) {
+        TaskNode* list = takeInbox();
+        count = 0;
+        work_ms = 0;
+        for (TaskNode* node = list; node != nullptr; node = node->next) {
+            count++;
+            work_ms += node->task.burst_time;
+        }
+        load -= count;
+        work -= work_ms;
+        return list;
+    }
+    
+    static long clockMs() {
+        return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>
+            (std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    
+    // Estimated milliseconds of work left: queued bursts plus what remains
+    // of the running task. Counters may be briefly negative while a
+    // consumer races a producer, so both parts are clamped.
+    long remainingWork(long now_ms) const {
+        long queued = std::max(0L, work.load(std::memory_order_relaxed));
+        long run_end = run_end_ms.load(std::memory_order_relaxed);
+        return queued + (run_end > now_ms ? run_end - now_ms : 0);
+    }
+    
+    // Owner only: move inbox tasks into the deque. The inbox is newest-first,
+    // so pushing in that order leaves the oldest at the bottom, where the
+    // owner pops next.
+    void drainInbox() {
+        TaskNode* node = takeInbox();
+        while (node != nullptr) {
+            TaskNode* next = node->next;
+            local_queue.push(node);
+            node = next;
         }
-        return false;
     }
     
     int getQueueSize() {
-        std::lock_guard<std::mutex> lock(queue_mutex);
-        return static_cast<int>(local_queue.size());
+        return load.load(std::memory_order_relaxed);
     }
     
     bool isEmpty() {
-        std::lock_guard<std::mutex> lock(queue_mutex);
-        return local_queue.empty();
+        return getQueueSize() == 0;
+    }
+    
+private:
+    static void freeList(TaskNode* node) {
+        while (node != nullptr) {
+            TaskNode* next = node->next;
+            TaskNode::release(node);
+            node = next;
+        }
+    }
+};
+
+// NUMA-aware scheduler simulation
+// Topology is read from /sys/devices/system/node. Hosts without sysfs
+// (non-Linux, restricted containers) fall back to a single node holding
+// every CPU, so placement degrades to plain least-loaded selection.
+class NUMAScheduler {
+private:
+    struct NUMANode {
+        int node_id;
+        std::vector<int> cpu_cores;
+        std::vector<int> distances; // ACPI SLIT distance to each node; 10 = local
+        
+        NUMANode(int id, std::vector<int> cores, std::vector<int> dist) 
+            : node_id(id), cpu_cores(std::move(cores)), distances(std::move(dist)) {}
+    };
+    
+    std::vector<NUMANode> numa_nodes;
+    std::vector<int> cpu_to_node; // indexed by CPU id, -1 when not online
+    
+    // Parse the kernel's cpulist format, e.g. "0-3,8-11"
+    static std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> cpus;
+        std::stringstream ss(list);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            if (range.empty() || !std::isdigit(static_cast<unsigned char>(range[0]))) continue;
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+    
+    bool discover(const std::string& sysfs_root) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        if (!fs::is_directory(sysfs_root, ec)) return false;
+        
+        for (const auto& entry : fs::directory_iterator(sysfs_root, ec)) {
+            std::string name = entry.path().filename().string();
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                continue;
+            }
+            
+            std::ifstream cpulist(entry.path() / "cpulist");
+            std::string list;
+            if (!std::getline(cpulist, list)) continue;
+            
+            std::vector<int> distances;
+            std::ifstream distance_file(entry.path() / "distance");
+            int d;
+            while (distance_file >> d) {
+                distances.push_back(d);
+            }
+            numa_nodes.emplace_back(std::stoi(name.substr(4)), parseCpuList(list), std::move(distances));
+        }
+        
+        // The distance rows are ordered by node id; memory-only nodes keep their slot
+        std::sort(numa_nodes.begin(), numa_nodes.end(),
+                  [](const NUMANode& a, const NUMANode& b) { return a.node_id < b.node_id; });
+        return std::any_of(numa_nodes.begin(), numa_nodes.end(),
+                           [](const NUMANode& n) { return !n.cpu_cores.empty(); });
+    }
+    
+    const NUMANode* findNode(int node_id) const {
+        for (const auto& node : numa_nodes) {
+            if (node.node_id == node_id) return &node;
+        }
+        return nullptr;
+    }
+    
+public:
+    explicit NUMAScheduler(const std::string& sysfs_root = "/sys/devices/system/node") {
+        if (!discover(sysfs_root)) {
+            numa_nodes.clear();
+            int cpu_count = std::max(1u, std::thread::hardware_concurrency());
+            std::vector<int> cpus(cpu_count);
+            for (int i = 0; i < cpu_count; i++) cpus[i] = i;
+            numa_nodes.emplace_back(0, std::move(cpus), std::vector<int>{10});
+        }
+        
+        for (const auto& node : numa_nodes) {
+            for (int cpu : node.cpu_cores) {
+                if (cpu >= static_cast<int>(cpu_to_node.size())) cpu_to_node.resize(cpu + 1, -1);
+                cpu_to_node[cpu] = node.node_id;
+            }
+        }
+    }
+    
+    int nodeCount() const { return static_cast<int>(numa_nodes.size()); }
+    
+    int nodeOfCpu(int cpu) const {
+        return (cpu >= 0 && cpu < static_cast<int>(cpu_to_node.size())) ? cpu_to_node[cpu] : -1;
+    }
+    
+    // Online CPUs interleaved across nodes (n0c0, n1c0, n0c1, ...), so
+    // simulated cores mapped in this order spread over every node
+    std::vector<int> allCpus() const {
+        std::vector<int> cpus;
+        for (size_t rank = 0; cpus.size() < cpu_to_node.size(); rank++) {
+            size_t before = cpus.size();
+            for (const auto& node : numa_nodes) {
+                if (rank < node.cpu_cores.size()) cpus.push_back(node.cpu_cores[rank]);
+            }
+            if (cpus.size() == before) break;
+        }
+        return cpus;
+    }
+    
+    int distance(int from_node, int to_node) const {
+        const NUMANode* from = findNode(from_node);
+        if (from == nullptr) return INT_MAX;
+        for (size_t i = 0; i < numa_nodes.size(); i++) {
+            if (numa_nodes[i].node_id == to_node) {
+                return i < from->distances.size() ? from->distances[i] : (from_node == to_node ? 10 : 20);
+            }
+        }
+        return INT_MAX;
+    }
+    
+    // Least-loaded CPU inside the preferred node, or across all nodes when
+    // there is no preference. cpu_load is indexed by CPU id; missing entries
+    // count as idle.
+    int selectOptimalCore(int preferred_node = -1, const std::vector<int>& cpu_load = {}) const {
+        auto loadOf = [&](int cpu) {
+            return cpu < static_cast<int>(cpu_load.size()) ? cpu_load[cpu] : 0;
+        };
+        
+        int best_cpu = -1;
+        int min_load = INT_MAX;
+        for (const auto& node : numa_nodes) {
+            if (preferred_node >= 0 && node.node_id != preferred_node) continue;
+            for (int cpu : node.cpu_cores) {
+                if (loadOf(cpu) < min_load) {
+                    min_load = loadOf(cpu);
+                    best_cpu = cpu;
+                }
+            }
+        }
+        
+        // Unknown or CPU-less node: fall back to any CPU
+        return (best_cpu < 0 && preferred_node >= 0) ? selectOptimalCore(-1, cpu_load) : best_cpu;
+    }
+    
+    void displayNUMATopology() const {
+        std::cout << "\n=== NUMA TOPOLOGY ===\n";
+        for (const auto& node : numa_nodes) {
+            std::cout << "NUMA Node " << node.node_id 
+                      << ": CPUs [";
+            for (size_t i = 0; i < node.cpu_cores.size(); i++) {
+                std::cout << node.cpu_cores[i];
+                if (i < node.cpu_cores.size() - 1) std::cout << ", ";
+            }
+            std::cout << "], Distances [";
+            for (size_t i = 0; i < node.distances.size(); i++) {
+                std::cout << node.distances[i];
+                if (i < node.distances.size() - 1) std::cout << ", ";
+            }
+            std::cout << "]\n";
+        }
     }
 };
 
@@ -76,100 +830,326 @@ private:
     std::vector<std::unique_ptr<CPUCore>> cores;
     std::queue<Task> global_queue;
     std::mutex global_mutex;
-    std::condition_variable cv;
     std::atomic<bool> running{true};
-    std::atomic<int> active_tasks{0};
-    std::atomic<int> completed_tasks{0};
+    CompletionLatch active_tasks;
+    std::atomic<int> parked_cores{0};
+    std::atomic<unsigned> next_wake{0};
+    std::atomic<unsigned> next_submit{0}; // round-robin cursor for unhinted batch tasks
+    
+    // addTasks() scratch: one chain per core
+    struct BatchChains {
+        std::vector<TaskNode*> heads;
+        std::vector<TaskNode*> tails;
+        std::vector<int> counts;
+        std::vector<long> work;
+        
+        void reset(int num_cores) {
+            heads.assign(num_cores, nullptr);
+            tails.assign(num_cores, nullptr);
+            counts.assign(num_cores, 0);
+            work.assign(num_cores, 0);
+        }
+    };
+    
     int num_cores;
     
-    // Load balancing parameters
-    static constexpr int LOAD_BALANCE_THRESHOLD = 2;
-    static constexpr int MIGRATION_COST = 5; // milliseconds
+    // Placement of simulated cores on real CPUs, set by setNUMATopology()
+    std::vector<int> core_cpu;
+    std::vector<int> core_node;
+    bool numa_aware = false;
+    bool pin_threads = false;
+    
+    std::mutex balancer_mutex;
+    std::condition_variable balancer_cv;
+    AsyncLogger event_log; // core threads never write to std::cout directly
+    
+    // Completions are counted down on the shared latch in batches, and
+    // always before a core parks, so the latch is not hit once per task
+    static constexpr int REPORT_BATCH = 32;
     
 public:
-    MultiProcessorScheduler(int cores_count) : num_cores(cores_count) {
+    // Load balancing parameters, shared with VirtualTimeScheduler
+    static constexpr int LOAD_BALANCE_THRESHOLD = 2; // minimum gap, in multiples of MIGRATION_COST
+    static constexpr int MIGRATION_COST = 5; // milliseconds
+    static constexpr int MIN_BALANCE_PERIOD = 1; // milliseconds
+    static constexpr int MAX_BALANCE_PERIOD = 100;
+    
+    // Event log lines go to 'log_stream'; benchmarks pass a sink stream
+    explicit MultiProcessorScheduler(int cores_count, std::ostream& log_stream = std::cout)
+        : num_cores(cores_count), event_log(log_stream) {
         cores.reserve(cores_count);
         for (int i = 0; i < cores_count; i++) {
             cores.push_back(std::make_unique<CPUCore>(i));
         }
+        core_cpu.assign(cores_count, -1);
+        core_node.assign(cores_count, 0);
+    }
+    
+    // Map simulated cores round-robin onto the host's CPUs, spread over nodes.
+    // Call before starting the core threads; with pin enabled each thread
+    // is bound to its CPU so node-local placement holds on real hardware.
+    void setNUMATopology(const NUMAScheduler& topology, bool pin = true) {
+        std::vector<int> cpus = topology.allCpus();
+        for (int i = 0; i < num_cores; i++) {
+            core_cpu[i] = cpus[i % cpus.size()];
+            core_node[i] = topology.nodeOfCpu(core_cpu[i]);
+        }
+        numa_aware = true;
+        pin_threads = pin;
+    }
+    
+    int coreNode(int core_id) const { return core_node[core_id]; }
+    
+    // Lowest-load core on a NUMA node, or -1 if no core maps there.
+    // 'pending' adds per-core counts not yet published (a batch being built).
+    int selectCoreForNode(int node, const std::vector<int>* pending = nullptr) const {
+        int best_core = -1;
+        int min_load = INT_MAX;
+        for (int i = 0; i < num_cores; i++) {
+            if (core_node[i] != node) continue;
+            int load = cores[i]->getQueueSize() + (cores[i]->is_busy.load(std::memory_order_relaxed) ? 1 : 0);
+            if (pending != nullptr) load += (*pending)[i];
+            if (load < min_load) {
+                min_load = load;
+                best_core = i;
+            }
+        }
+        return best_core;
     }
     
     void addTask(const Task& task) {
-        if (task.preferred_cpu >= 0 && task.preferred_cpu < num_cores) {
+        // Count the task before publishing it so the latch cannot hit zero early
+        active_tasks.add();
+        int target = (task.preferred_cpu < num_cores) ? task.preferred_cpu : -1;
+        if (target < 0 && numa_aware && task.memory_node >= 0) {
+            // Memory affinity - least-loaded core next to the task's data
+            target = selectCoreForNode(task.memory_node);
+        }
+        
+        if (target >= 0) {
             // Processor affinity - try preferred CPU first
-            cores[task.preferred_cpu]->addTask(task);
+            cores[target]->addTask(task);
         } else {
             // Global queue for load balancing
             std::lock_guard<std::mutex> lock(global_mutex);
             global_queue.push(task);
         }
-        active_tasks++;
-        cv.notify_all();
+        wakeOneCore(target);
+    }
+    
+    // Bulk submission over a span of tasks, which are moved from. Tasks are
+    // sorted into one chain per core in a single pass: affinity and memory
+    // hints are honoured as in addTask(), the rest are dealt round-robin.
+    // The nodes share one NodeBlock and the per-core chains are kept in
+    // per-thread scratch, so a batch costs a single allocation. Each chain
+    // is published with one CAS and each affected core is woken at most
+    // once.
+    void addTasks(Task* batch, size_t count) {
+        if (count == 0) return;
+        active_tasks.add(static_cast<int>(count));
+        
+        thread_local BatchChains chains;
+        chains.reset(num_cores);
+        std::vector<TaskNode*>& heads = chains.heads;
+        std::vector<TaskNode*>& tails = chains.tails;
+        std::vector<int>& counts = chains.counts;
+        std::vector<long>& work = chains.work;
+        NodeBlock* block = nullptr;
+        TaskNode* nodes = NodeBlock::allocate(count, block);
+        unsigned next_core = next_submit.fetch_add(static_cast<unsigned>(count),
+                                                   std::memory_order_relaxed);
+        
+        for (size_t t = 0; t < count; t++) {
+            Task& task = batch[t];
+            int target = (task.preferred_cpu < num_cores) ? task.preferred_cpu : -1;
+            if (target < 0 && numa_aware && task.memory_node >= 0) {
+                target = selectCoreForNode(task.memory_node, &counts);
+            }
+            if (target < 0) {
+                target = static_cast<int>(next_core++ % num_cores);
+            }
+            
+            TaskNode* node = new (nodes + t) TaskNode(std::move(task));
+            node->block = block;
+            node->next = heads[target];
+            heads[target] = node;
+            if (tails[target] == nullptr) tails[target] = node;
+            counts[target]++;
+            work[target] += heads[target]->task.burst_time;
+        }
+        
+        for (int i = 0; i < num_cores; i++) {
+            if (counts[i] > 0) cores[i]->addTasks(heads[i], tails[i], counts[i], work[i]);
+        }
+        
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_cores.load() == 0) return;
+        for (int i = 0; i < num_cores; i++) {
+            if (counts[i] > 0) tryWakeCore(i);
+        }
+    }
+    
+    void addTasks(std::vector<Task>&& batch) {
+        addTasks(batch.data(), batch.size());
+        batch.clear();
+    }
+    
+    // Claim a parked core's wakeup; exactly one caller can win the claim
+    bool tryWakeCore(int core_id) {
+        CPUCore& core = *cores[core_id];
+        if (core.parked.load(std::memory_order_relaxed) && core.parked.exchange(false)) {
+            parked_cores--;
+            core.parker.unpark();
+            return true;
+        }
+        return false;
+    }
+    
+    // Wake one parked core for newly published work, preferring the task's
+    // affine core. Costs a fence and one load when no core is parked.
+    void wakeOneCore(int preferred_core = -1) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_cores.load() == 0) return;
+        
+        if (preferred_core >= 0 && preferred_core < num_cores && tryWakeCore(preferred_core)) {
+            return;
+        }
+        int start = next_wake.fetch_add(1, std::memory_order_relaxed) % num_cores;
+        for (int i = 0; i < num_cores; i++) {
+            if (tryWakeCore((start + i) % num_cores)) return;
+        }
+    }
+    
+    void wakeAllCores() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (int i = 0; i < num_cores; i++) {
+            tryWakeCore(i);
+        }
+    }
+    
+    // Local queue first (processor affinity), then the global queue, then stealing
+    bool findTask(int core_id, Task& task) {
+        if (cores[core_id]->getTask(task)) {
+            return true;
+        }
+        {
+            std::lock_guard<std::mutex> lock(global_mutex);
+            if (!global_queue.empty()) {
+                task = global_queue.front();
+                global_queue.pop();
+                return true;
+            }
+        }
+        return workStealing(core_id, task);
     }
     
     void cpuScheduler(int core_id) {
-        std::cout << "CPU Core " << core_id << " scheduler started\n";
+        event_log.log(AsyncLogger::LOG_CORE_STARTED, core_id);
+        CPUCore& core = *cores[core_id];
         
-        while (running.load() || active_tasks.load() > 0) {
+#if defined(__linux__)
+        if (pin_threads && core_cpu[core_id] >= 0) {
+            // Best effort: a restricted cpuset just leaves the thread unpinned
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(core_cpu[core_id], &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+#endif
+        
+        while (running.load() || active_tasks.pending() > 0) {
             Task current_task(0, 0);
-            bool has_task = false;
             
-            // Try to get task from local queue first (processor affinity)
-            if (cores[core_id]->getTask(current_task)) {
-                has_task = true;
-            }
-            // Try global queue
-            else {
-                std::lock_guard<std::mutex> lock(global_mutex);
-                if (!global_queue.empty()) {
-                    current_task = global_queue.front();
-                    global_queue.pop();
-                    has_task = true;
-                }
+            if (findTask(core_id, current_task)) {
+                executeTask(core_id, current_task);
+                continue;
             }
             
-            // Work stealing - try to steal from other cores
-            if (!has_task) {
-                has_task = workStealing(core_id, current_task);
-            }
+            reportCompletions(core_id);
             
-            if (has_task) {
-                executeTask(core_id, current_task);
-            } else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // Announce that this core is idle, then look again: a task
+            // published before the announcement is found here, and one
+            // published after it sees the flag and wakes this core
+            parked_cores++;
+            core.parked.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            
+            bool found = findTask(core_id, current_task);
+            bool finished = !running.load() && active_tasks.pending() == 0;
+            if (found || finished) {
+                if (core.parked.exchange(false)) {
+                    parked_cores--;
+                } else {
+                    core.parker.park(); // a producer already claimed us; consume its wakeup
+                }
+                if (found) executeTask(core_id, current_task);
+                continue;
             }
+            
+            core.parker.park();
         }
         
-        std::cout << "CPU Core " << core_id << " scheduler stopped\n";
+        event_log.log(AsyncLogger::LOG_CORE_STOPPED, core_id);
     }
     
+    // Visit every other core once, starting at a random victim. Take the
+    // oldest task from its deque or, failing that, adopt its undrained inbox.
+    // Cores on the thief's own NUMA node are tried before remote ones.
     bool workStealing(int core_id, Task& stolen_task) {
-        // Find the most loaded core
-        int max_load = 0;
-        int victim_core = -1;
+        if (num_cores < 2) return false;
         
-        for (int i = 0; i < num_cores; i++) {
-            if (i != core_id && cores[i]->getQueueSize() > max_load + LOAD_BALANCE_THRESHOLD) {
-                max_load = cores[i]->getQueueSize();
-                victim_core = i;
+        thread_local std::mt19937 rng(std::random_device{}());
+        int start = std::uniform_int_distribution<>(0, num_cores - 2)(rng);
+        
+        for (int pass = 0; pass < 2; pass++) {
+            for (int attempt = 0; attempt < num_cores - 1; attempt++) {
+                int victim_core = (core_id + 1 + (start + attempt) % (num_cores - 1)) % num_cores;
+                bool local = core_node[victim_core] == core_node[core_id];
+                if (local != (pass == 0)) continue;
+                if (trySteal(core_id, victim_core, stolen_task)) return true;
             }
         }
         
-        if (victim_core != -1 && cores[victim_core]->getTask(stolen_task)) {
-            std::cout << "Core " << core_id << " stole task " << stolen_task.task_id 
-                      << " from Core " << victim_core << "\n";
+        return false;
+    }
+    
+    bool trySteal(int core_id, int victim_core, Task& stolen_task) {
+        CPUCore& victim = *cores[victim_core];
+        
+        if (victim.stealTask(stolen_task)) {
+            CoreStats::bump(cores[core_id]->stats.stolen);
+            event_log.log(AsyncLogger::LOG_STOLE, core_id, stolen_task.task_id, victim_core);
             return true;
         }
         
+        int moved = 0;
+        long moved_work = 0;
+        TaskNode* adopted = victim.takeInboxTasks(moved, moved_work);
+        if (adopted != nullptr) {
+            while (adopted != nullptr) {
+                TaskNode* next = adopted->next;
+                cores[core_id]->local_queue.push(adopted);
+                adopted = next;
+            }
+            cores[core_id]->load += moved;
+            cores[core_id]->work += moved_work;
+            CoreStats::bump(cores[core_id]->stats.stolen, moved);
+            
+            if (cores[core_id]->getTask(stolen_task)) {
+                event_log.log(AsyncLogger::LOG_STOLE, core_id, stolen_task.task_id, victim_core);
+                return true;
+            }
+        }
+        
         return false;
     }
     
     void executeTask(int core_id, Task& task) {
-        cores[core_id]->is_busy = true;
+        cores[core_id]->is_busy.store(true, std::memory_order_relaxed);
+        cores[core_id]->run_end_ms.store(CPUCore::clockMs() + task.burst_time, std::memory_order_relaxed);
         task.start_time = std::chrono::steady_clock::now();
         
-        std::cout << "Core " << core_id << " executing Task " << task.task_id 
-                  << " (Burst: " << task.burst_time << "ms)\n";
+        event_log.log(AsyncLogger::LOG_EXECUTING, core_id, task.task_id, -1, task.burst_time);
         
         // Simulate task execution
         std::this_thread::sleep_for(std::chrono::milliseconds(task.burst_time));
@@ -179,136 +1159,842 @@ public:
         auto turnaround_time = std::chrono::duration_cast<std::chrono::milliseconds>
             (task.completion_time - task.arrival_time);
         
-        std::cout << "Core " << core_id << " completed Task " << task.task_id 
-                  << " (Turnaround: " << turnaround_time.count() << "ms)\n";
+        event_log.log(AsyncLogger::LOG_COMPLETED, core_id, task.task_id, -1, turnaround_time.count());
         
-        cores[core_id]->is_busy = false;
-        active_tasks--;
-        completed_tasks++;
+        CPUCore& core = *cores[core_id];
+        auto micros = [](std::chrono::steady_clock::duration d) {
+            return static_cast<uint64_t>(std::max<long long>(0,
+                std::chrono::duration_cast<std::chrono::microseconds>(d).count()));
+        };
+        core.wait_histogram.record(micros(task.start_time - task.arrival_time));
+        core.run_histogram.record(micros(task.completion_time - task.start_time));
+        core.turnaround_histogram.record(micros(task.completion_time - task.arrival_time));
+        core.is_busy.store(false, std::memory_order_relaxed);
+        core.run_end_ms.store(0, std::memory_order_relaxed);
+        CoreStats::bump(core.stats.completed);
+        CoreStats::bump(core.stats.busy_ms, std::chrono::duration_cast<std::chrono::milliseconds>
+            (task.completion_time - task.start_time).count());
+        if (++core.unreported >= REPORT_BATCH) {
+            reportCompletions(core_id);
+        }
     }
     
-    void loadBalancer() {
-        while (running.load()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // Owner only: count this core's finished tasks down on the shared latch
+    void reportCompletions(int core_id) {
+        CPUCore& core = *cores[core_id];
+        if (core.unreported == 0) return;
+        bool last = active_tasks.countDown(core.unreported);
+        core.unreported = 0;
+        if (last && !running.load()) {
+            // Parked cores only need to notice shutdown once the work is gone
+            wakeAllCores();
+        }
+    }
+    
+    // Aggregated on read; exact once the cores are idle
+    uint64_t completedTasks() const {
+        uint64_t total = 0;
+        for (const auto& core : cores) {
+            total += core->stats.completed.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+    
+    // One balancing pass. Only cores with queued tasks can give work away;
+    // they are ranked by estimated remaining work and paired, busiest first,
+    // with the cores that have the least. Each pair moves a batch of tasks
+    // aiming to halve its gap; a task is only moved while the receiver,
+    // charged MIGRATION_COST per task, still finishes before the sender
+    // would have. Returns the number of tasks moved.
+    int rebalance() {
+        long now = CPUCore::clockMs();
+        std::vector<long> work(num_cores);
+        std::vector<int> senders;
+        std::vector<int> receivers(num_cores);
+        for (int i = 0; i < num_cores; i++) {
+            work[i] = cores[i]->remainingWork(now);
+            receivers[i] = i;
+            if (cores[i]->getQueueSize() > 0) senders.push_back(i);
+        }
+        if (senders.empty()) return 0;
+        
+        auto busier = [&](int a, int b) { return work[a] != work[b] ? work[a] > work[b] : a < b; };
+        std::sort(senders.begin(), senders.end(), busier);
+        std::partial_sort(receivers.begin(), receivers.begin() + senders.size(), receivers.end(),
+                          [&](int a, int b) { return busier(b, a); });
+        
+        int migrated = 0;
+        for (size_t k = 0; k < senders.size(); k++) {
+            int src = senders[k];
+            int dst = receivers[k];
+            long gap = work[src] - work[dst];
+            if (gap <= LOAD_BALANCE_THRESHOLD * MIGRATION_COST) break;
             
-            // Check load imbalance
-            int min_load = INT_MAX;
-            int max_load = 0;
-            int min_core = -1;
-            int max_core = -1;
+            // Candidates come from the top of the sender's deque, then from
+            // its inbox, which a core busy on a long task has not drained
+            int inbox_count = 0;
+            long inbox_work = 0;
+            TaskNode* inbox_list = nullptr;
+            bool inbox_taken = false;
             
-            for (int i = 0; i < num_cores; i++) {
-                int load = cores[i]->getQueueSize();
-                if (load < min_load) {
-                    min_load = load;
-                    min_core = i;
+            TaskNode* head = nullptr;
+            TaskNode* tail = nullptr;
+            int count = 0;
+            long moved = 0;
+            while (moved < gap / 2) {
+                TaskNode* node = cores[src]->stealNode();
+                if (node == nullptr) {
+                    if (!inbox_taken) {
+                        inbox_list = cores[src]->takeInboxTasks(inbox_count, inbox_work);
+                        inbox_taken = true;
+                    }
+                    if (inbox_list == nullptr) break;
+                    node = inbox_list;
+                    inbox_list = node->next;
                 }
-                if (load > max_load) {
-                    max_load = load;
-                    max_core = i;
+                
+                long burst = node->task.burst_time;
+                long receiver_finish = work[dst] + moved + burst + (count + 1) * MIGRATION_COST;
+                if (receiver_finish >= work[src] - moved) {
+                    // No expected gain: hand the task back to its core
+                    cores[src]->addTasks(node, node, 1, burst);
+                    break;
                 }
+                node->next = head;
+                head = node;
+                if (tail == nullptr) tail = node;
+                count++;
+                moved += burst;
             }
             
-            // Migrate tasks if imbalance is significant
-            if (max_load - min_load > LOAD_BALANCE_THRESHOLD && max_core != -1 && min_core != -1) {
-                Task migrated_task(0, 0);
-                if (cores[max_core]->getTask(migrated_task)) {
-                    cores[min_core]->addTask(migrated_task);
-                    std::cout << "Load Balancer: Migrated Task " << migrated_task.task_id 
-                              << " from Core " << max_core << " to Core " << min_core << "\n";
+            if (inbox_list != nullptr) {
+                // Return the untouched rest of the inbox in one splice
+                TaskNode* rest_tail = inbox_list;
+                int rest_count = 1;
+                long rest_work = rest_tail->task.burst_time;
+                while (rest_tail->next != nullptr) {
+                    rest_tail = rest_tail->next;
+                    rest_count++;
+                    rest_work += rest_tail->task.burst_time;
                 }
+                cores[src]->addTasks(inbox_list, rest_tail, rest_count, rest_work);
+            }
+            
+            if (count > 0) {
+                cores[dst]->addTasks(head, tail, count, moved);
+                wakeOneCore(dst);
+                migrated += count;
+                event_log.log(AsyncLogger::LOG_MIGRATED, src, dst, count, moved);
+            }
+        }
+        return migrated;
+    }
+    
+    // The period halves while migrations keep happening, so a skewed burst
+    // is worked off within a few milliseconds, and doubles back towards
+    // MAX_BALANCE_PERIOD once a pass finds nothing worth moving.
+    void loadBalancer() {
+        int period = MAX_BALANCE_PERIOD;
+        while (running.load()) {
+            {
+                std::unique_lock<std::mutex> lock(balancer_mutex);
+                balancer_cv.wait_for(lock, std::chrono::milliseconds(period),
+                                     [this] { return !running.load(); });
+            }
+            if (!running.load()) break;
+            
+            if (rebalance() > 0) {
+                period = std::max(MIN_BALANCE_PERIOD, period / 2);
+            } else {
+                period = std::min(MAX_BALANCE_PERIOD, period * 2);
             }
         }
     }
     
     void waitForCompletion() {
-        // Wait until all tasks are completed
-        while (active_tasks.load() > 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // Block until the last task counts the latch down
+        active_tasks.wait();
+    }
+    
+    // Merge one histogram across all cores, e.g. &CPUCore::turnaround_histogram
+    LatencyHistogram mergedHistogram(LatencyHistogram CPUCore::*which) const {
+        LatencyHistogram merged;
+        for (const auto& core : cores) {
+            merged.merge((*core).*which);
         }
+        return merged;
     }
     
+    void flushLog() { event_log.flush(); }
+    
     void displayStats() {
+        event_log.flush();
         std::cout << "\n=== CPU CORE STATISTICS ===\n";
         for (int i = 0; i < num_cores; i++) {
+            const CoreStats& stats = cores[i]->stats;
             std::cout << "Core " << i << ": Queue Size = " << cores[i]->getQueueSize()
-                      << ", Busy = " << (cores[i]->is_busy.load() ? "Yes" : "No") << "\n";
+                      << ", Busy = " << (cores[i]->is_busy.load() ? "Yes" : "No")
+                      << ", Completed = " << stats.completed.load(std::memory_order_relaxed)
+                      << ", Stolen = " << stats.stolen.load(std::memory_order_relaxed)
+                      << ", Busy Time = " << stats.busy_ms.load(std::memory_order_relaxed) << "ms\n";
+        }
+        std::cout << "Active Tasks: " << active_tasks.pending() << "\n";
+        std::cout << "Completed Tasks: " << completedTasks() << "\n";
+        
+        std::cout << "\n=== LATENCY PERCENTILES (ms) ===\n";
+        std::cout << std::left << std::setw(14) << "Metric" << std::right
+                  << std::setw(10) << "p50" << std::setw(10) << "p99"
+                  << std::setw(10) << "p999" << std::setw(10) << "max" << "\n";
+        const std::pair<const char*, LatencyHistogram CPUCore::*> metrics[] = {
+            {"Queue Wait", &CPUCore::wait_histogram},
+            {"Run Time", &CPUCore::run_histogram},
+            {"Turnaround", &CPUCore::turnaround_histogram},
+        };
+        std::cout << std::fixed << std::setprecision(2);
+        for (const auto& metric : metrics) {
+            LatencyHistogram merged = mergedHistogram(metric.second);
+            std::cout << std::left << std::setw(14) << metric.first << std::right
+                      << std::setw(10) << merged.valueAtQuantile(0.50) / 1000.0
+                      << std::setw(10) << merged.valueAtQuantile(0.99) / 1000.0
+                      << std::setw(10) << merged.valueAtQuantile(0.999) / 1000.0
+                      << std::setw(10) << merged.maxValue() / 1000.0 << "\n";
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        if (event_log.droppedRecords() > 0) {
+            std::cout << "Dropped Log Records: " << event_log.droppedRecords() << "\n";
         }
-        std::cout << "Active Tasks: " << active_tasks.load() << "\n";
-        std::cout << "Completed Tasks: " << completed_tasks.load() << "\n";
     }
     
     void stop() {
-        running = false;
-        cv.notify_all();
+        {
+            std::lock_guard<std::mutex> lock(balancer_mutex);
+            running = false;
+        }
+        balancer_cv.notify_all();
+        wakeAllCores();
     }
 };
 
-// NUMA-aware scheduler simulation
-class NUMAScheduler {
+// Task description for virtual-time runs; times are virtual milliseconds
+struct VirtualTask {
+    int task_id;
+    int burst_time;
+    long arrival_time;
+    int preferred_cpu;
+    int memory_node;
+};
+
+struct VirtualRunStats {
+    long makespan = 0;
+    double avg_turnaround = 0;
+    double avg_waiting = 0;
+    long steals = 0;
+    long migrations = 0;
+    long events = 0;
+    uint64_t schedule_hash = 0; // equal seeds and inputs give equal hashes
+};
+
+// Deterministic virtual-clock counterpart of MultiProcessorScheduler. A
+// single thread replays the same placement, stealing and balancing rules
+// against a global event queue, so nothing sleeps and the seed fixes every
+// random choice. Each core has an inbox and a deque like CPUCore: the owner
+// drains the inbox onto the bottom of the deque, oldest last, and pops from
+// the bottom, while thieves and the balancer take the top and fall back to
+// the undrained inbox. Tasks that change cores (stolen or migrated) pay
+// MIGRATION_COST on top of their burst.
+class VirtualTimeScheduler {
 private:
-    struct NUMANode {
-        int node_id;
-        std::vector<int> cpu_cores;
-        int memory_latency; // Access latency in nanoseconds
+    enum EventType { EVENT_COMPLETE, EVENT_BALANCE };
+    
+    struct Event {
+        long time;
+        uint64_t seq; // FIFO among events at the same time
+        EventType type;
+        int core;
         
-        NUMANode(int id, std::vector<int> cores, int latency) 
-            : node_id(id), cpu_cores(std::move(cores)), memory_latency(latency) {}
+        // Completions go before a balancer tick at the same time, so the
+        // order does not depend on when the tick was scheduled
+        bool operator>(const Event& other) const {
+            if (time != other.time) return time > other.time;
+            if (type != other.type) return type > other.type;
+            return seq > other.seq;
+        }
     };
     
-    std::vector<NUMANode> numa_nodes;
+    struct VirtualCore {
+        std::deque<int> local;  // task indices; back is the bottom
+        std::vector<int> inbox; // submitted, not yet drained; oldest first
+        long queued_work = 0;
+        long run_end = 0;
+        int running = -1;      // task index, -1 when idle
+        int node = 0;
+        int stealable_pos = -1; // position in stealable[node]
+        int idle_pos = -1;      // position in idle_cores
+    };
     
-public:
-    NUMAScheduler() {
-        // Simulate 2 NUMA nodes
-        numa_nodes.emplace_back(0, std::vector<int>{0, 1}, 100); // Local access
-        numa_nodes.emplace_back(1, std::vector<int>{2, 3}, 300); // Remote access
+    using MPS = MultiProcessorScheduler;
+    
+    int num_cores;
+    uint64_t seed;
+    std::vector<VirtualCore> cores;
+    std::vector<std::vector<int>> node_cores;
+    std::vector<std::vector<int>> stealable; // per node: cores with queued tasks
+    std::vector<int> idle_cores;
+    std::deque<int> global_queue;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    std::mt19937_64 rng;
+    uint64_t next_seq = 0;
+    std::vector<long> work;      // rebalance() scratch
+    std::vector<int> senders;
+    std::vector<int> receivers;
+    
+    const std::vector<VirtualTask>* tasks = nullptr;
+    std::vector<long> start_time;
+    std::vector<char> migrated;
+    long completed = 0;
+    double total_turnaround = 0;
+    double total_waiting = 0;
+    VirtualRunStats stats;
+    
+    static void removeAt(std::vector<int>& list, int& pos, std::vector<VirtualCore>& all,
+                         int VirtualCore::*field) {
+        int last = list.back();
+        list[pos] = last;
+        all[last].*field = pos;
+        list.pop_back();
+        pos = -1;
     }
     
-    int selectOptimalCore(int preferred_node = -1) {
-        if (preferred_node >= 0 && preferred_node < static_cast<int>(numa_nodes.size())) {
-            // Return first available core from preferred NUMA node
-            const auto& node = numa_nodes[preferred_node];
-            if (!node.cpu_cores.empty()) {
-                return node.cpu_cores[0];
-            }
+    void markIdle(int core) {
+        cores[core].idle_pos = static_cast<int>(idle_cores.size());
+        idle_cores.push_back(core);
+    }
+    
+    void clearIdle(int core) {
+        removeAt(idle_cores, cores[core].idle_pos, cores, &VirtualCore::idle_pos);
+    }
+    
+    bool hasQueued(int core) const {
+        return !cores[core].local.empty() || !cores[core].inbox.empty();
+    }
+    
+    // Keep stealable[] in step with whether the core has anything queued
+    void track(int core) {
+        VirtualCore& c = cores[core];
+        bool queued = hasQueued(core);
+        if (queued && c.stealable_pos < 0) {
+            c.stealable_pos = static_cast<int>(stealable[c.node].size());
+            stealable[c.node].push_back(core);
+        } else if (!queued && c.stealable_pos >= 0) {
+            removeAt(stealable[c.node], c.stealable_pos, cores, &VirtualCore::stealable_pos);
+        }
+    }
+    
+    // CPUCore::addTask(): the task becomes the newest in the inbox
+    void submit(int core, int idx) {
+        cores[core].inbox.push_back(idx);
+        cores[core].queued_work += (*tasks)[idx].burst_time;
+        track(core);
+    }
+    
+    // CPUCore::drainInbox(): newest first onto the bottom, so the oldest
+    // submitted task is popped next
+    void drainInbox(int core) {
+        VirtualCore& c = cores[core];
+        for (auto it = c.inbox.rbegin(); it != c.inbox.rend(); ++it) c.local.push_back(*it);
+        c.inbox.clear();
+    }
+    
+    // CPUCore::getTask()
+    int takeOwn(int core) {
+        drainInbox(core);
+        VirtualCore& c = cores[core];
+        int idx = c.local.back();
+        c.local.pop_back();
+        c.queued_work -= (*tasks)[idx].burst_time;
+        track(core);
+        return idx;
+    }
+    
+    // CPUCore::stealNode(); -1 when the deque is empty
+    int takeTop(int core) {
+        VirtualCore& c = cores[core];
+        if (c.local.empty()) return -1;
+        int idx = c.local.front();
+        c.local.pop_front();
+        c.queued_work -= (*tasks)[idx].burst_time;
+        track(core);
+        return idx;
+    }
+    
+    // MultiProcessorScheduler::trySteal(): the top of the victim's deque,
+    // otherwise its whole inbox, of which the thief runs the oldest
+    int stealFrom(int core, int victim) {
+        int idx = takeTop(victim);
+        if (idx >= 0) {
+            stats.steals++;
+            return idx;
+        }
+        VirtualCore& v = cores[victim];
+        VirtualCore& c = cores[core];
+        for (auto it = v.inbox.rbegin(); it != v.inbox.rend(); ++it) {
+            c.local.push_back(*it);
+            c.queued_work += (*tasks)[*it].burst_time;
+            v.queued_work -= (*tasks)[*it].burst_time;
+            migrated[*it] = 1;
+            stats.steals++;
+        }
+        v.inbox.clear();
+        track(victim);
+        track(core);
+        return takeOwn(core);
+    }
+    
+    // Random victim on the thief's node first, then on each other node once,
+    // starting from a random one, as workStealing() visits every core
+    int steal(int core) {
+        int home = cores[core].node;
+        int num_nodes = static_cast<int>(stealable.size());
+        int offset = num_nodes > 1 ? static_cast<int>(rng() % (num_nodes - 1)) : 0;
+        for (int i = 0; i < num_nodes; i++) {
+            int node = (i == 0) ? home : (home + 1 + (offset + i - 1) % (num_nodes - 1)) % num_nodes;
+            const std::vector<int>& victims = stealable[node];
+            if (victims.empty()) continue;
+            int victim = victims[rng() % victims.size()];
+            return stealFrom(core, victim);
+        }
+        return -1;
+    }
+    
+    bool nothingQueued() const {
+        for (const auto& list : stealable) {
+            if (!list.empty()) return false;
+        }
+        return true;
+    }
+    
+    void schedule(long time, EventType type, int core) {
+        events.push(Event{time, next_seq++, type, core});
+    }
+    
+    // Same order as MultiProcessorScheduler::findTask(): local, global, steal
+    void dispatch(int core, long now) {
+        int idx = -1;
+        bool moved = false;
+        if (hasQueued(core)) {
+            idx = takeOwn(core);
+        } else if (!global_queue.empty()) {
+            idx = global_queue.front();
+            global_queue.pop_front();
+        } else {
+            idx = steal(core);
+            moved = idx >= 0;
         }
         
-        // Find node with lowest memory latency that has available cores
-        int best_node = 0;
-        int min_latency = numa_nodes[0].memory_latency;
+        if (idx < 0) {
+            markIdle(core);
+            return;
+        }
         
-        for (size_t i = 1; i < numa_nodes.size(); i++) {
-            if (numa_nodes[i].memory_latency < min_latency) {
-                min_latency = numa_nodes[i].memory_latency;
-                best_node = static_cast<int>(i);
+        VirtualCore& c = cores[core];
+        c.running = idx;
+        c.run_end = now + (*tasks)[idx].burst_time + ((moved || migrated[idx]) ? MPS::MIGRATION_COST : 0);
+        start_time[idx] = now;
+        schedule(c.run_end, EVENT_COMPLETE, core);
+    }
+    
+    int selectCoreForNode(int node) const {
+        if (node < 0 || node >= static_cast<int>(node_cores.size())) return -1;
+        int best_core = -1;
+        long min_load = LONG_MAX;
+        for (int core : node_cores[node]) {
+            const VirtualCore& c = cores[core];
+            long load = static_cast<long>(c.local.size() + c.inbox.size()) + (c.running >= 0 ? 1 : 0);
+            if (load < min_load) {
+                min_load = load;
+                best_core = core;
             }
         }
+        return best_core;
+    }
+    
+    // Mirrors MultiProcessorScheduler::addTask() and wakeOneCore()
+    void arrive(int idx, long now) {
+        const VirtualTask& task = (*tasks)[idx];
+        int target = (task.preferred_cpu < num_cores) ? task.preferred_cpu : -1;
+        if (target < 0 && task.memory_node >= 0) {
+            target = selectCoreForNode(task.memory_node);
+        }
+        
+        if (target >= 0) {
+            submit(target, idx);
+        } else {
+            global_queue.push_back(idx);
+        }
         
-        return numa_nodes[best_node].cpu_cores[0];
+        int wake = -1;
+        if (target >= 0 && cores[target].running < 0) {
+            wake = target;
+        } else if (!idle_cores.empty()) {
+            wake = idle_cores.back();
+        }
+        if (wake >= 0) {
+            clearIdle(wake);
+            dispatch(wake, now);
+        }
     }
     
-    void displayNUMATopology() {
-        std::cout << "\n=== NUMA TOPOLOGY ===\n";
-        for (const auto& node : numa_nodes) {
-            std::cout << "NUMA Node " << node.node_id 
-                      << ": CPUs [";
-            for (size_t i = 0; i < node.cpu_cores.size(); i++) {
-                std::cout << node.cpu_cores[i];
-                if (i < node.cpu_cores.size() - 1) std::cout << ", ";
+    void complete(int core, long now) {
+        VirtualCore& c = cores[core];
+        int idx = c.running;
+        const VirtualTask& task = (*tasks)[idx];
+        c.running = -1;
+        
+        completed++;
+        total_turnaround += now - task.arrival_time;
+        total_waiting += start_time[idx] - task.arrival_time;
+        stats.makespan = std::max(stats.makespan, now);
+        
+        // FNV-1a over (task, core, finish) in completion order
+        for (uint64_t word : {static_cast<uint64_t>(task.task_id), static_cast<uint64_t>(core),
+                              static_cast<uint64_t>(now)}) {
+            stats.schedule_hash = (stats.schedule_hash ^ word) * 1099511628211ULL;
+        }
+        
+        dispatch(core, now);
+    }
+    
+    // MultiProcessorScheduler::rebalance() over the virtual queues. The
+    // senders are exactly the stealable cores, so a pass with nothing queued
+    // costs nothing. Candidates come from the top of the deque, then from
+    // the inbox newest first; a rejected one goes back as the newest inbox
+    // task, ahead of the untouched rest, as addTasks() leaves it.
+    int rebalance(long now) {
+        senders.clear();
+        for (const auto& list : stealable) {
+            senders.insert(senders.end(), list.begin(), list.end());
+        }
+        if (senders.empty()) return 0;
+        
+        for (int i = 0; i < num_cores; i++) {
+            const VirtualCore& c = cores[i];
+            work[i] = c.queued_work + (c.running >= 0 && c.run_end > now ? c.run_end - now : 0);
+            receivers[i] = i;
+        }
+        auto busier = [&](int a, int b) { return work[a] != work[b] ? work[a] > work[b] : a < b; };
+        std::sort(senders.begin(), senders.end(), busier);
+        std::partial_sort(receivers.begin(), receivers.begin() + senders.size(), receivers.end(),
+                          [&](int a, int b) { return busier(b, a); });
+        
+        int moved_tasks = 0;
+        for (size_t k = 0; k < senders.size(); k++) {
+            int src = senders[k];
+            int dst = receivers[k];
+            long gap = work[src] - work[dst];
+            if (gap <= MPS::LOAD_BALANCE_THRESHOLD * MPS::MIGRATION_COST) break;
+            
+            int count = 0;
+            long moved = 0;
+            while (moved < gap / 2 && hasQueued(src)) {
+                VirtualCore& s = cores[src];
+                bool from_deque = !s.local.empty();
+                int idx = from_deque ? s.local.front() : s.inbox.back();
+                if (from_deque) s.local.pop_front(); else s.inbox.pop_back();
+                
+                long burst = (*tasks)[idx].burst_time;
+                long receiver_finish = work[dst] + moved + burst + (count + 1) * MPS::MIGRATION_COST;
+                if (receiver_finish >= work[src] - moved) {
+                    if (from_deque) s.inbox.push_back(idx);
+                    else s.inbox.insert(s.inbox.begin(), idx);
+                    break;
+                }
+                
+                s.queued_work -= burst;
+                migrated[idx] = 1;
+                submit(dst, idx);
+                count++;
+                moved += burst;
+            }
+            track(src);
+            
+            if (count > 0) {
+                moved_tasks += count;
+                if (cores[dst].running < 0) {
+                    clearIdle(dst);
+                    dispatch(dst, now);
+                }
+            }
+        }
+        stats.migrations += moved_tasks;
+        return moved_tasks;
+    }
+    
+public:
+    VirtualTimeScheduler(int cores_count, uint64_t rng_seed)
+        : num_cores(cores_count), seed(rng_seed), cores(cores_count),
+          work(cores_count), receivers(cores_count) {
+        setNodeCount(1);
+    }
+    
+    // Split the virtual cores into contiguous, equally sized NUMA nodes.
+    // Synthetic rather than read from the host so runs reproduce anywhere.
+    void setNodeCount(int nodes) {
+        nodes = std::max(1, std::min(nodes, num_cores));
+        node_cores.assign(nodes, {});
+        for (int i = 0; i < num_cores; i++) {
+            cores[i].node = static_cast<int>(static_cast<long>(i) * nodes / num_cores);
+            node_cores[cores[i].node].push_back(i);
+        }
+    }
+    
+    VirtualRunStats run(const std::vector<VirtualTask>& workload) {
+        tasks = &workload;
+        size_t n = workload.size();
+        start_time.assign(n, 0);
+        migrated.assign(n, 0);
+        completed = 0;
+        total_turnaround = 0;
+        total_waiting = 0;
+        stats = VirtualRunStats();
+        stats.schedule_hash = 14695981039346656037ULL;
+        rng.seed(seed);
+        next_seq = 0;
+        events = decltype(events)();
+        global_queue.clear();
+        stealable.assign(node_cores.size(), {});
+        idle_cores.clear();
+        for (int i = 0; i < num_cores; i++) {
+            int node = cores[i].node;
+            cores[i] = VirtualCore();
+            cores[i].node = node;
+            markIdle(i);
+        }
+        if (n == 0) return stats;
+        
+        // Arrivals stream from a sorted cursor; only completions and
+        // balancer ticks go through the heap, which stays O(cores)
+        std::vector<int> arrival_order(n);
+        for (size_t i = 0; i < n; i++) arrival_order[i] = static_cast<int>(i);
+        std::stable_sort(arrival_order.begin(), arrival_order.end(), [&](int a, int b) {
+            return workload[a].arrival_time < workload[b].arrival_time;
+        });
+        
+        int period = MPS::MAX_BALANCE_PERIOD;
+        schedule(workload[arrival_order[0]].arrival_time + period, EVENT_BALANCE, -1);
+        
+        size_t next_arrival = 0;
+        while (completed < static_cast<long>(n)) {
+            stats.events++;
+            if (next_arrival < n &&
+                (events.empty() || workload[arrival_order[next_arrival]].arrival_time <= events.top().time)) {
+                int idx = arrival_order[next_arrival++];
+                arrive(idx, workload[idx].arrival_time);
+                continue;
+            }
+            
+            Event event = events.top();
+            events.pop();
+            if (event.type == EVENT_COMPLETE) {
+                complete(event.core, event.time);
+            } else {
+                if (rebalance(event.time) > 0) {
+                    period = std::max(MPS::MIN_BALANCE_PERIOD, period / 2);
+                } else {
+                    period = std::min(MPS::MAX_BALANCE_PERIOD, period * 2);
+                }
+                long next_tick = event.time + period;
+                if (nothingQueued()) {
+                    // Only an arrival can queue a task, so every tick before
+                    // the next one would find no sender and just double the
+                    // period: apply those doublings and jump past the gap
+                    if (next_arrival == n) continue;
+                    long arrival = workload[arrival_order[next_arrival]].arrival_time;
+                    while (next_tick < arrival && period < MPS::MAX_BALANCE_PERIOD) {
+                        period = std::min(MPS::MAX_BALANCE_PERIOD, period * 2);
+                        next_tick += period;
+                    }
+                    if (next_tick < arrival) {
+                        next_tick += (arrival - next_tick + period - 1) / period * period;
+                    }
+                }
+                schedule(next_tick, EVENT_BALANCE, -1);
             }
-            std::cout << "], Memory Latency: " << node.memory_latency << "ns\n";
         }
+        
+        stats.avg_turnaround = total_turnaround / n;
+        stats.avg_waiting = total_waiting / n;
+        return stats;
     }
 };
 
-int main() {
+// Seeded workload shaped like the demo: 50-200 ms bursts, Poisson arrivals
+// at about 90% utilisation, every third task pinned to a core and every
+// third (offset by one) carrying a memory-node hint
+std::vector<VirtualTask> generateVirtualWorkload(long count, int num_cores, int num_nodes, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<int> burst_dist(50, 200);
+    std::uniform_int_distribution<int> core_dist(0, num_cores - 1);
+    std::uniform_int_distribution<int> node_dist(0, num_nodes - 1);
+    std::exponential_distribution<double> gap_dist(num_cores * 0.9 / 125.0);
+    
+    std::vector<VirtualTask> workload;
+    workload.reserve(count);
+    double clock = 0;
+    for (long i = 1; i <= count; i++) {
+        clock += gap_dist(gen);
+        int burst = burst_dist(gen);
+        int cpu = (i % 3 == 0) ? core_dist(gen) : -1;
+        int node = (i % 3 == 1) ? node_dist(gen) : -1;
+        workload.push_back(VirtualTask{static_cast<int>(i), burst, static_cast<long>(clock), cpu, node});
+    }
+    return workload;
+}
+
+void runVirtualSimulation(long count, int num_cores, int num_nodes, uint64_t seed) {
+    std::vector<VirtualTask> workload = generateVirtualWorkload(count, num_cores, num_nodes, seed);
+    
+    VirtualTimeScheduler simulator(num_cores, seed);
+    simulator.setNodeCount(num_nodes);
+    
+    auto start = std::chrono::steady_clock::now();
+    VirtualRunStats stats = simulator.run(workload);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    std::cout << "=== VIRTUAL-TIME SIMULATION (" << count << " tasks, " << num_cores
+              << " cores, " << num_nodes << " nodes, seed " << seed << ") ===\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Makespan: " << stats.makespan << " ms (virtual)\n";
+    std::cout << "Average Turnaround: " << stats.avg_turnaround << " ms\n";
+    std::cout << "Average Waiting: " << stats.avg_waiting << " ms\n";
+    std::cout << "Steals: " << stats.steals << ", Migrations: " << stats.migrations << "\n";
+    std::cout << "Events: " << stats.events << "\n";
+    std::cout << "Schedule Hash: " << std::hex << stats.schedule_hash << std::dec << "\n";
+    std::cout << "Wall Time: " << seconds * 1000 << " ms\n";
+}
+
+// False-sharing benchmark: every thread bumps only its own counter, so any
+// slowdown versus the padded layout is cache-line ping-pong. "shared" is
+// the old single completed_tasks atomic, "packed" puts per-core counters
+// side by side (8 per line), "padded" is the CoreStats layout.
+void runFalseSharingBenchmark(int threads, long ops) {
+    using Clock = std::chrono::steady_clock;
+    
+    auto measure = [&](const char* layout, auto&& bump) {
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                ready++;
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                for (long i = 0; i < ops; i++) bump(t);
+            });
+        }
+        while (ready.load() < threads) std::this_thread::yield();
+        
+        auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& worker : workers) worker.join();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        
+        double total_ops = static_cast<double>(ops) * threads;
+        std::cout << std::left << std::setw(8) << layout << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(12) << seconds * 1e9 / total_ops << " ns/op"
+                  << std::setw(12) << total_ops / seconds / 1e6 << " Mops/s\n";
+    };
+    
+    std::cout << "=== FALSE SHARING BENCHMARK (" << threads << " threads, " << ops
+              << " increments each, " << std::thread::hardware_concurrency() << " hardware threads) ===\n";
+    
+    std::atomic<uint64_t> shared{0};
+    measure("shared", [&](int) { shared.fetch_add(1, std::memory_order_relaxed); });
+    
+    std::unique_ptr<std::atomic<uint64_t>[]> packed(new std::atomic<uint64_t>[threads]);
+    for (int t = 0; t < threads; t++) packed[t].store(0);
+    measure("packed", [&](int t) { CoreStats::bump(packed[t]); });
+    
+    std::unique_ptr<CoreStats[]> padded(new CoreStats[threads]);
+    measure("padded", [&](int t) { CoreStats::bump(padded[t].completed); });
+}
+
+// Producer-side submission throughput: one task at a time through addTask()
+// versus batches through addTasks(). Tasks are built before the clock starts
+// and no core threads run, so the numbers measure publication alone; queued
+// tasks are freed with the scheduler.
+void runSubmissionBenchmark(int num_cores, long tasks, int batch_size) {
+    using Clock = std::chrono::steady_clock;
+    
+    auto report = [&](const char* mode, Clock::time_point start) {
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << std::left << std::setw(16) << mode << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(10) << tasks / seconds / 1e6 << " M tasks/s\n";
+    };
+    
+    std::cout << "=== SUBMISSION BENCHMARK (" << tasks << " tasks, " << num_cores
+              << " cores, batch " << batch_size << ") ===\n";
+    
+    std::vector<Task> pool;
+    pool.reserve(tasks);
+    for (long i = 0; i < tasks; i++) {
+        pool.emplace_back(static_cast<int>(i), 1);
+    }
+    
+    {
+        MultiProcessorScheduler scheduler(num_cores);
+        auto start = Clock::now();
+        for (const Task& task : pool) {
+            scheduler.addTask(task);
+        }
+        report("addTask", start);
+    }
+    
+    {
+        MultiProcessorScheduler scheduler(num_cores);
+        auto start = Clock::now();
+        for (long i = 0; i < tasks; i += batch_size) {
+            scheduler.addTasks(pool.data() + i, static_cast<size_t>(std::min<long>(batch_size, tasks - i)));
+        }
+        report("addTasks", start);
+    }
+}
+
+int main(int argc, char* argv[]) {
     try {
+        if (argc >= 2 && std::string(argv[1]) == "--false-sharing") {
+            // Usage: --false-sharing [THREADS] [OPS_PER_THREAD]
+            int threads = argc >= 3 ? std::atoi(argv[2])
+                                    : std::max(32, static_cast<int>(std::thread::hardware_concurrency()));
+            long ops = argc >= 4 ? std::atol(argv[3]) : 2000000;
+            runFalseSharingBenchmark(std::max(1, threads), std::max(1L, ops));
+            return 0;
+        }
+        if (argc >= 2 && std::string(argv[1]) == "--virtual") {
+            // Usage: --virtual [TASKS] [CORES] [NODES] [SEED]
+            long tasks = argc >= 3 ? std::atol(argv[2]) : 1000000;
+            int num_cores = argc >= 4 ? std::atoi(argv[3]) : 256;
+            int num_nodes = argc >= 5 ? std::atoi(argv[4]) : 4;
+            uint64_t seed = argc >= 6 ? std::strtoull(argv[5], nullptr, 10) : 42;
+            runVirtualSimulation(std::max(1L, tasks), std::max(1, num_cores), std::max(1, num_nodes), seed);
+            return 0;
+        }
+        if (argc >= 2 && std::string(argv[1]) == "--submit-bench") {
+            // Usage: --submit-bench [TASKS] [BATCH] [CORES]
+            long tasks = argc >= 3 ? std::atol(argv[2]) : 2000000;
+            int batch = argc >= 4 ? std::atoi(argv[3]) : 1024;
+            int num_cores = argc >= 5 ? std::atoi(argv[4]) : 8;
+            runSubmissionBenchmark(std::max(1, num_cores), std::max(1L, tasks), std::max(1, batch));
+            return 0;
+        }
+        
         std::cout << "=== MULTI-PROCESSOR SCHEDULING DEMO ===\n\n";
         
         const int NUM_CORES = 4;
         MultiProcessorScheduler scheduler(NUM_CORES);
         
+        // Place simulated cores on the host's NUMA topology
+        NUMAScheduler numa_scheduler;
+        scheduler.setNUMATopology(numa_scheduler);
+        
         // Start CPU schedulers
         std::vector<std::thread> cpu_threads;
         for (int i = 0; i < NUM_CORES; i++) {
@@ -323,17 +2009,21 @@ int main() {
         std::mt19937 gen(rd());
         std::uniform_int_distribution<> burst_dist(50, 200);
         std::uniform_int_distribution<> affinity_dist(0, NUM_CORES - 1);
+        std::uniform_int_distribution<> node_dist(0, numa_scheduler.nodeCount() - 1);
         
         std::cout << "Generating tasks...\n";
         for (int i = 1; i <= 12; i++) {
             int burst_time = burst_dist(gen);
             int preferred_cpu = (i % 3 == 0) ? affinity_dist(gen) : -1; // Some tasks have affinity
+            int memory_node = (i % 3 == 1) ? node_dist(gen) : -1;     // Some have data on a node
             
-            Task task(i, burst_time, preferred_cpu);
+            Task task(i, burst_time, preferred_cpu, memory_node);
             scheduler.addTask(task);
             
             if (preferred_cpu >= 0) {
                 std::cout << "Added Task " << i << " with CPU affinity to Core " << preferred_cpu << "\n";
+            } else if (memory_node >= 0) {
+                std::cout << "Added Task " << i << " with memory on NUMA node " << memory_node << "\n";
             } else {
                 std::cout << "Added Task " << i << " without CPU affinity\n";
             }
@@ -347,11 +2037,12 @@ int main() {
         scheduler.displayStats();
         
         // Demonstrate NUMA awareness
-        NUMAScheduler numa_scheduler;
         numa_scheduler.displayNUMATopology();
         
-        std::cout << "\nOptimal core for NUMA node 0: " << numa_scheduler.selectOptimalCore(0) << "\n";
-        std::cout << "Optimal core for NUMA node 1: " << numa_scheduler.selectOptimalCore(1) << "\n";
+        for (int node = 0; node < numa_scheduler.nodeCount(); node++) {
+            std::cout << (node == 0 ? "\n" : "") << "Optimal core for NUMA node " << node
+                      << ": " << numa_scheduler.selectOptimalCore(node) << "\n";
+        }
         
         // Stop scheduler
         scheduler.stop();
@@ -366,6 +2057,7 @@ int main() {
             }
         }
         
+        scheduler.flushLog();
         std::cout << "\nMulti-processor scheduling demo completed!\n";
         
     } catch (const std::exception& e) {
@@ -1,10 +1,22 @@
 // File: scheduling_metrics.cpp
-// Compile: g++ -o scheduling_metrics scheduling_metrics.cpp -std=c++17
+// Compile: g++ -O2 -march=native -o scheduling_metrics scheduling_metrics.cpp -std=c++17
+//          (-march=native, or -mavx2, enables the AVX2 column reductions;
+//          without it the scalar loops are used)
 
 #include <iostream>
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <climits>
+#include <cmath>
+#include <random>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include "../common/online_metrics.h"
 
 struct Process {
     int pid;
@@ -21,56 +33,222 @@ struct Process {
           remaining_time(bt), priority(pr) {}
 };
 
+// Column-oriented process results: one contiguous array per field, so a
+// metric only streams the column it needs instead of striding over records
+class ProcessTable {
+public:
+    std::vector<int> pid;
+    std::vector<int> arrival_time;
+    std::vector<int> burst_time;
+    std::vector<int> completion_time;
+    std::vector<int> turnaround_time;
+    std::vector<int> waiting_time;
+    std::vector<int> response_time; // first dispatch - arrival; optional
+    
+    void reserve(size_t n) {
+        pid.reserve(n);
+        arrival_time.reserve(n);
+        burst_time.reserve(n);
+        completion_time.reserve(n);
+        turnaround_time.reserve(n);
+        waiting_time.reserve(n);
+        response_time.reserve(n);
+    }
+    
+    void append(const Process& p) {
+        pid.push_back(p.pid);
+        arrival_time.push_back(p.arrival_time);
+        burst_time.push_back(p.burst_time);
+        completion_time.push_back(p.completion_time);
+        turnaround_time.push_back(p.turnaround_time);
+        waiting_time.push_back(p.waiting_time);
+    }
+    
+    void clear() {
+        pid.clear();
+        arrival_time.clear();
+        burst_time.clear();
+        completion_time.clear();
+        turnaround_time.clear();
+        waiting_time.clear();
+        response_time.clear();
+    }
+    
+    size_t size() const { return pid.size(); }
+    bool empty() const { return pid.empty(); }
+};
+
+// Reductions over a single int column. The AVX2 paths process eight values
+// per step; the scalar loops handle the tail and non-AVX2 builds.
+class ColumnReductions {
+public:
+    static long long sum(const std::vector<int>& column) {
+        const int* data = column.data();
+        size_t n = column.size();
+        size_t i = 0;
+        long long total = 0;
+        
+#if defined(__AVX2__)
+        // Widen to 64-bit lanes so large result sets cannot overflow
+        __m256i acc_lo = _mm256_setzero_si256();
+        __m256i acc_hi = _mm256_setzero_si256();
+        for (; i + 8 <= n; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            acc_lo = _mm256_add_epi64(acc_lo, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+            acc_hi = _mm256_add_epi64(acc_hi, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+        }
+        alignas(32) long long lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc_lo, acc_hi));
+        total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+        
+        for (; i < n; i++) {
+            total += data[i];
+        }
+        return total;
+    }
+    
+    static int max(const std::vector<int>& column) {
+        const int* data = column.data();
+        size_t n = column.size();
+        size_t i = 0;
+        int result = INT_MIN;
+        
+#if defined(__AVX2__)
+        __m256i acc = _mm256_set1_epi32(INT_MIN);
+        for (; i + 8 <= n; i += 8) {
+            acc = _mm256_max_epi32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+        }
+        alignas(32) int lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        for (int lane : lanes) {
+            result = std::max(result, lane);
+        }
+#endif
+        
+        for (; i < n; i++) {
+            result = std::max(result, data[i]);
+        }
+        return result;
+    }
+    
+    // Nearest-rank percentiles (each q in [0, 1]): the value at rank
+    // ceil(q * n), as in QuantileSketch. One scratch copy serves every q;
+    // the quantiles are selected in rank order, each within the part of
+    // the copy the previous selection left above it.
+    static std::vector<int> percentiles(const std::vector<int>& column, const std::vector<double>& qs) {
+        std::vector<int> result(qs.size(), 0);
+        if (column.empty()) return result;
+        
+        size_t n = column.size();
+        std::vector<std::pair<size_t, size_t>> ranks; // (index in sorted order, position in qs)
+        for (size_t i = 0; i < qs.size(); i++) {
+            size_t rank = static_cast<size_t>(std::ceil(qs[i] * n));
+            ranks.emplace_back(std::min(std::max<size_t>(rank, 1), n) - 1, i);
+        }
+        std::sort(ranks.begin(), ranks.end());
+        
+        std::vector<int> scratch(column);
+        auto first = scratch.begin();
+        for (const auto& r : ranks) {
+            auto nth = scratch.begin() + r.first;
+            if (nth >= first) {
+                std::nth_element(first, nth, scratch.end());
+                first = nth + 1;
+            }
+            result[r.second] = *nth;
+        }
+        return result;
+    }
+    
+    static int percentile(const std::vector<int>& column, double q) {
+        return percentiles(column, {q})[0];
+    }
+};
+
 class MetricsCalculator {
 private:
-    std::vector<Process> processes;
-    int total_time;
-    int cpu_idle_time;
+    ProcessTable processes;
+    int total_time = 0;
+    int cpu_idle_time = 0;
 
 public:
     void setProcesses(const std::vector<Process>& procs) {
-        processes = procs;
+        processes.clear();
+        processes.reserve(procs.size());
+        for (const auto& p : procs) {
+            processes.append(p);
+        }
+        calculateTotalTime();
+    }
+    
+    // Take an already columnar result set without going through Process rows
+    void setProcesses(ProcessTable&& table) {
+        processes = std::move(table);
         calculateTotalTime();
     }
     
     void calculateTotalTime() {
-        if (processes.empty()) return;
-        
-        int max_completion = 0;
-        for (const auto& p : processes) {
-            max_completion = std::max(max_completion, p.completion_time);
-        }
-        total_time = max_completion;
+        total_time = processes.empty() ? 0 : std::max(0, ColumnReductions::max(processes.completion_time));
     }
     
     double getCPUUtilization() {
+        if (total_time <= 0) return 0.0;
         int cpu_busy_time = total_time - cpu_idle_time;
         return (static_cast<double>(cpu_busy_time) / total_time) * 100.0;
     }
     
     double getThroughput() {
+        if (total_time <= 0) return 0.0;
         return static_cast<double>(processes.size()) / total_time;
     }
     
     double getAverageWaitingTime() {
-        int total_waiting = 0;
-        for (const auto& p : processes) {
-            total_waiting += p.waiting_time;
-        }
+        if (processes.empty()) return 0.0;
+        long long total_waiting = ColumnReductions::sum(processes.waiting_time);
         return static_cast<double>(total_waiting) / processes.size();
     }
     
     double getAverageTurnaroundTime() {
-        int total_turnaround = 0;
-        for (const auto& p : processes) {
-            total_turnaround += p.turnaround_time;
-        }
+        if (processes.empty()) return 0.0;
+        long long total_turnaround = ColumnReductions::sum(processes.turnaround_time);
         return static_cast<double>(total_turnaround) / processes.size();
     }
     
+    int getMaxCompletionTime() {
+        return processes.empty() ? 0 : ColumnReductions::max(processes.completion_time);
+    }
+    
+    int getWaitingTimePercentile(double q) {
+        return ColumnReductions::percentile(processes.waiting_time, q);
+    }
+    
+    int getTurnaroundTimePercentile(double q) {
+        return ColumnReductions::percentile(processes.turnaround_time, q);
+    }
+    
+    // Several percentiles of one column for the cost of a single copy
+    std::vector<int> getWaitingTimePercentiles(const std::vector<double>& qs) {
+        return ColumnReductions::percentiles(processes.waiting_time, qs);
+    }
+    
+    std::vector<int> getTurnaroundTimePercentiles(const std::vector<double>& qs) {
+        return ColumnReductions::percentiles(processes.turnaround_time, qs);
+    }
+    
+    // Response times come from a scheduler timeline (first time on the CPU
+    // minus arrival). Without them, fall back to waiting time, which is
+    // only exact for non-preemptive policies.
+    void setResponseTimes(const std::vector<int>& times) {
+        processes.response_time = times;
+    }
+    
     double getAverageResponseTime() {
-        // Assuming response time equals waiting time for simplicity
-        return getAverageWaitingTime();
+        if (processes.response_time.size() != processes.size() || processes.empty()) {
+            return getAverageWaitingTime();
+        }
+        long long total_response = ColumnReductions::sum(processes.response_time);
+        return static_cast<double>(total_response) / processes.size();
     }
     
     void displayMetrics() {
@@ -81,13 +259,58 @@ public:
         std::cout << "Average Waiting Time: " << getAverageWaitingTime() << " units\n";
         std::cout << "Average Turnaround Time: " << getAverageTurnaroundTime() << " units\n";
         std::cout << "Average Response Time: " << getAverageResponseTime() << " units\n";
+        std::vector<int> waiting = getWaitingTimePercentiles({0.50, 0.99});
+        std::vector<int> turnaround = getTurnaroundTimePercentiles({0.50, 0.99});
+        std::cout << "Waiting Time p50/p99: " << waiting[0] << " / " << waiting[1] << " units\n";
+        std::cout << "Turnaround Time p50/p99: " << turnaround[0] << " / " << turnaround[1] << " units\n";
     }
     
     void setCPUIdleTime(int idle) { cpu_idle_time = idle; }
 };
 
+// Synthetic multi-hour replay: a single FCFS CPU fed Poisson arrivals.
+// Events are generated and consumed one at a time; a snapshot is printed
+// every tenth of the run the way a live dashboard would poll.
+void runStreamingReplay(long long events) {
+    std::mt19937 gen(7);
+    std::exponential_distribution<double> gap(1.0 / 10.0);
+    std::uniform_int_distribution<int> burst(1, 16);
+    
+    OnlineMetrics metrics;
+    double arrival_clock = 0;
+    int cpu_free_at = 0;
+    long long report_every = std::max(1LL, events / 10);
+    auto start = std::chrono::steady_clock::now();
+    
+    for (long long i = 0; i < events; i++) {
+        arrival_clock += gap(gen);
+        int arrival = static_cast<int>(arrival_clock);
+        int bt = burst(gen);
+        int begin = std::max(cpu_free_at, arrival);
+        cpu_free_at = begin + bt;
+        metrics.record(CompletionEvent{static_cast<int>(i), arrival, bt, cpu_free_at, begin - arrival});
+        
+        if ((i + 1) % report_every == 0) {
+            OnlineMetrics::Snapshot s = metrics.snapshot();
+            std::cout << std::fixed << std::setprecision(2) << "[live] completed " << s.completed
+                      << ", utilization " << s.cpu_utilization << "%, waiting mean " << s.waiting.mean
+                      << " p99 " << s.waiting.p99 << "\n";
+        }
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    OnlineMetrics::display(metrics.snapshot());
+    std::cout << "Replay rate: " << events / seconds / 1e6 << " M events/s\n";
+}
+
 // Demo usage
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && std::string(argv[1]) == "--replay") {
+        // Usage: --replay [EVENTS]
+        runStreamingReplay(argc >= 3 ? std::max(1LL, std::atoll(argv[2])) : 10000000LL);
+        return 0;
+    }
+    
     std::vector<Process> sample_processes = {
         Process(1, 0, 7), Process(2, 2, 4), Process(3, 4, 1)
     };
@@ -107,8 +330,17 @@ int main() {
     
     MetricsCalculator calc;
     calc.setProcesses(sample_processes);
+    calc.setResponseTimes({0, 5, 7}); // FCFS order: each process runs once, when it stops waiting
     calc.setCPUIdleTime(0);
     calc.displayMetrics();
     
+    // Same results fed one completion at a time
+    OnlineMetrics online;
+    const int response_times[] = {0, 5, 7};
+    for (size_t i = 0; i < sample_processes.size(); i++) {
+        online.record(sample_processes[i], response_times[i]);
+    }
+    OnlineMetrics::display(online.snapshot());
+    
     return 0;
 }
@@ -0,0 +1,398 @@
+// Scheduler Benchmark - throughput, wall time and peak RSS of the Lab4 engines
+// Build: cmake -S . -B build && cmake --build build --target sched_bench
+// Usage: sched_bench [--sizes N,N,...] [--engines E,E,...] [--cores C] [--quantum Q]
+//                    [--load L] [--seed S] [--no-fork]
+// Engines: fcfs sjf srtf rr priority (streaming uniprocessor engine), mc-srtf
+// mc-edf (multi-core preemptive engine), mp (threaded MultiProcessorScheduler),
+// mp-virtual (VirtualTimeScheduler). Results are one JSON document on stdout.
+
+// Everything the lab sources include is pulled in first, so their own
+// #includes are no-ops inside the namespaces below and each lab keeps its
+// own Process/Task types without clashing. Shared headers from common/ are
+// included here too and so stay at global scope.
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <deque>
+#include <set>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <cctype>
+#include <stdexcept>
+#include <utility>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(__unix__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#include "../common/online_metrics.h"
+#include "../common/spin_wait.h"
+
+#define main complete_scheduling_main
+namespace uniprocessor {
+#include "Complete Scheduling Algorithms.cpp"
+}
+#undef main
+
+#define main multiprocessor_main
+namespace multiprocessor {
+#include "Multi-Processor Scheduling Simulation.cpp"
+}
+#undef main
+
+// Synthetic workload: Poisson arrivals and bounded-Pareto bursts (shape 1.5,
+// 1..MAX_BURST), the heavy tail that separates SJF/SRTF from FCFS. The mean
+// gap is chosen so the offered load is 'load' per CPU.
+class SyntheticWorkload {
+public:
+    static constexpr double PARETO_SHAPE = 1.5;
+    static constexpr int MAX_BURST = 10000;
+
+private:
+    std::mt19937_64 gen;
+    std::uniform_real_distribution<double> unit{0.0, 1.0};
+    std::exponential_distribution<double> gap;
+    std::uniform_int_distribution<int> priority{0, 9};
+    long long remaining;
+    long long next_pid = 0;
+    double clock = 0;
+
+public:
+    // Mean of the continuous bounded Pareto on [1, MAX_BURST]
+    static double meanBurst() {
+        double a = PARETO_SHAPE;
+        double h = MAX_BURST;
+        return (1.0 / (1.0 - std::pow(1.0 / h, a))) * (a / (a - 1.0)) * (1.0 - std::pow(1.0 / h, a - 1.0));
+    }
+
+    SyntheticWorkload(long long count, double load, int cpus, uint64_t seed)
+        : gen(seed), gap(load * cpus / meanBurst()), remaining(count) {}
+
+    int nextBurst() {
+        // Inverse CDF of the bounded Pareto
+        double a = PARETO_SHAPE;
+        double h_a = std::pow(1.0 / MAX_BURST, a);
+        double x = std::pow(1.0 - unit(gen) * (1.0 - h_a), -1.0 / a);
+        return std::max(1, std::min(MAX_BURST, static_cast<int>(std::lround(x))));
+    }
+
+    bool next(int& pid, int& arrival, int& burst, int& prio) {
+        if (remaining == 0) return false;
+        remaining--;
+        clock += gap(gen);
+        pid = static_cast<int>(next_pid++);
+        arrival = static_cast<int>(clock);
+        burst = nextBurst();
+        prio = priority(gen);
+        return true;
+    }
+
+    // Source interface of the streaming uniprocessor engine
+    bool next(uniprocessor::Process& p) {
+        int pid, arrival, burst, prio;
+        if (!next(pid, arrival, burst, prio)) return false;
+        p = uniprocessor::Process(pid, arrival, burst, prio);
+        return true;
+    }
+};
+
+struct CaseResult {
+    long long processes = 0;
+    double wall_seconds = 0;
+    double avg_waiting = 0;
+    double avg_turnaround = 0;
+    long long makespan = 0;
+    long peak_rss_kb = 0;
+    bool ok = false;
+};
+
+struct BenchConfig {
+    std::vector<long long> sizes{1000, 10000, 100000, 1000000};
+    std::vector<std::string> engines{"fcfs", "sjf", "srtf", "rr", "priority", "mc-srtf", "mc-edf",
+                                     "mp", "mp-virtual"};
+    int cores = 4;
+    int quantum = 4;
+    double load = 0.9;
+    uint64_t seed = 42;
+    bool fork_cases = true;
+};
+
+using Clock = std::chrono::steady_clock;
+
+CaseResult runUniprocessor(const std::string& engine, long long count, const BenchConfig& config) {
+    using namespace uniprocessor;
+    SyntheticWorkload workload(count, config.load, 1, config.seed);
+    MetricsAccumulator metrics;
+
+    auto start = Clock::now();
+    SchedulingAlgorithms::run(SchedulingAlgorithms::parsePolicy(engine), workload, config.quantum,
+                              [&](const Process& p) { metrics.add(p); });
+
+    CaseResult result;
+    result.wall_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    MetricsAccumulator::Snapshot summary = metrics.snapshot();
+    result.processes = summary.completed;
+    result.avg_waiting = summary.waiting.mean;
+    result.avg_turnaround = summary.turnaround.mean;
+    result.makespan = summary.makespan;
+    return result;
+}
+
+// Global preemptive SRTF/EDF over 'cores' CPUs; the engine is in-memory, so
+// the workload is materialised first and only the replay is timed. EDF
+// deadlines are arrival + 2 x burst.
+CaseResult runMultiCore(const std::string& engine, long long count, const BenchConfig& config) {
+    using namespace uniprocessor;
+    SyntheticWorkload workload(count, config.load, config.cores, config.seed);
+    std::vector<Process> processes;
+    processes.reserve(count);
+    Process p(0, 0, 0);
+    while (workload.next(p)) {
+        processes.push_back(p);
+    }
+
+    auto start = Clock::now();
+    if (engine == "mc-srtf") {
+        SchedulingAlgorithms::MultiCoreSRTF(processes, config.cores);
+    } else {
+        SchedulingAlgorithms::MultiCoreEDF(processes, config.cores,
+            [](const Process& q) { return q.arrival_time + 2 * q.burst_time; });
+    }
+
+    CaseResult result;
+    result.wall_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    MetricsAccumulator metrics;
+    for (const Process& q : processes) {
+        metrics.add(q);
+    }
+    MetricsAccumulator::Snapshot summary = metrics.snapshot();
+    result.processes = summary.completed;
+    result.avg_waiting = summary.waiting.mean;
+    result.avg_turnaround = summary.turnaround.mean;
+    result.makespan = summary.makespan;
+    return result;
+}
+
+// Threaded engine. Tasks run for real, so bursts are zero and the number is
+// dispatch overhead (submission, stealing, balancing, logging). Submission
+// is windowed so queued tasks stay bounded at any count.
+CaseResult runMultiprocessor(long long count, const BenchConfig& config) {
+    using namespace multiprocessor;
+    const long long WINDOW = 1 << 16;
+    const size_t BATCH = 256;
+
+    std::ostream sink(nullptr); // event log records are formatted into nothing
+    MultiProcessorScheduler scheduler(config.cores, sink);
+    std::vector<std::thread> cpu_threads;
+    for (int i = 0; i < config.cores; i++) {
+        cpu_threads.emplace_back(&MultiProcessorScheduler::cpuScheduler, &scheduler, i);
+    }
+    std::thread balancer(&MultiProcessorScheduler::loadBalancer, &scheduler);
+
+    std::vector<Task> batch;
+    batch.reserve(BATCH);
+    auto start = Clock::now();
+    for (long long submitted = 0; submitted < count;) {
+        while (submitted - static_cast<long long>(scheduler.completedTasks()) > WINDOW) {
+            std::this_thread::yield();
+        }
+        batch.clear();
+        for (size_t i = 0; i < BATCH && submitted < count; i++, submitted++) {
+            batch.emplace_back(static_cast<int>(submitted), 0);
+        }
+        scheduler.addTasks(batch.data(), batch.size());
+    }
+    scheduler.waitForCompletion();
+
+    CaseResult result;
+    result.wall_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.processes = static_cast<long long>(scheduler.completedTasks());
+
+    scheduler.stop();
+    balancer.join();
+    for (auto& thread : cpu_threads) thread.join();
+    return result;
+}
+
+CaseResult runMultiprocessorVirtual(long long count, const BenchConfig& config) {
+    using namespace multiprocessor;
+    SyntheticWorkload workload(count, config.load, config.cores, config.seed);
+    std::vector<VirtualTask> tasks;
+    tasks.reserve(count);
+    int pid, arrival, burst, prio;
+    while (workload.next(pid, arrival, burst, prio)) {
+        tasks.push_back(VirtualTask{pid, burst, arrival, -1, -1});
+    }
+
+    VirtualTimeScheduler simulator(config.cores, config.seed);
+    auto start = Clock::now();
+    VirtualRunStats stats = simulator.run(tasks);
+
+    CaseResult result;
+    result.wall_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.processes = count;
+    result.avg_waiting = stats.avg_waiting;
+    result.avg_turnaround = stats.avg_turnaround;
+    result.makespan = stats.makespan;
+    return result;
+}
+
+CaseResult runCase(const std::string& engine, long long count, const BenchConfig& config) {
+    if (engine == "mp") return runMultiprocessor(count, config);
+    if (engine == "mp-virtual") return runMultiprocessorVirtual(count, config);
+    if (engine == "mc-srtf" || engine == "mc-edf") return runMultiCore(engine, count, config);
+    return runUniprocessor(engine, count, config);
+}
+
+// Each case runs in a child process so peak RSS is that case's alone;
+// the parent collects the result over a pipe and ru_maxrss from wait4()
+CaseResult measureCase(const std::string& engine, long long count, const BenchConfig& config) {
+#if defined(__unix__)
+    if (config.fork_cases) {
+        int fds[2];
+        if (pipe(fds) != 0) throw std::runtime_error("pipe failed");
+        std::cout.flush();
+        pid_t child = fork();
+        if (child < 0) throw std::runtime_error("fork failed");
+        if (child == 0) {
+            close(fds[0]);
+            CaseResult result;
+            try {
+                result = runCase(engine, count, config);
+                result.ok = true;
+            } catch (const std::exception& e) {
+                std::cerr << engine << " " << count << ": " << e.what() << "\n";
+            }
+            ssize_t written = write(fds[1], &result, sizeof(result));
+            _exit(written == static_cast<ssize_t>(sizeof(result)) ? 0 : 1);
+        }
+        close(fds[1]);
+        CaseResult result;
+        ssize_t got = read(fds[0], &result, sizeof(result));
+        close(fds[0]);
+        int status = 0;
+        struct rusage usage;
+        wait4(child, &status, 0, &usage);
+        if (got != static_cast<ssize_t>(sizeof(result)) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            result = CaseResult();
+        }
+        result.peak_rss_kb = usage.ru_maxrss;
+        return result;
+    }
+#endif
+    CaseResult result = runCase(engine, count, config);
+    result.ok = true;
+#if defined(__unix__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result.peak_rss_kb = usage.ru_maxrss; // process-wide high-water mark so far
+#endif
+    return result;
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+BenchConfig parseArgs(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--sizes") {
+            config.sizes.clear();
+            for (const std::string& n : splitList(value())) config.sizes.push_back(std::stoll(n));
+        } else if (arg == "--engines") {
+            config.engines = splitList(value());
+        } else if (arg == "--cores") {
+            config.cores = std::max(1, std::stoi(value()));
+        } else if (arg == "--quantum") {
+            config.quantum = std::max(1, std::stoi(value()));
+        } else if (arg == "--load") {
+            config.load = std::stod(value());
+        } else if (arg == "--seed") {
+            config.seed = std::stoull(value());
+        } else if (arg == "--no-fork") {
+            config.fork_cases = false;
+        } else {
+            throw std::runtime_error("unknown argument " + arg);
+        }
+    }
+    for (const std::string& engine : config.engines) {
+        if (engine != "mp" && engine != "mp-virtual" && engine != "mc-srtf" && engine != "mc-edf") {
+            uniprocessor::SchedulingAlgorithms::parsePolicy(engine); // throws on typos
+        }
+    }
+    if (config.load <= 0) throw std::runtime_error("--load must be positive");
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchConfig config = parseArgs(argc, argv);
+        bool all_ok = true;
+
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "{\n  \"benchmark\": \"sched_bench\",\n"
+                  << "  \"seed\": " << config.seed << ",\n"
+                  << "  \"load\": " << config.load << ",\n"
+                  << "  \"cores\": " << config.cores << ",\n"
+                  << "  \"quantum\": " << config.quantum << ",\n"
+                  << "  \"results\": [";
+        bool first = true;
+        for (long long size : config.sizes) {
+            for (const std::string& engine : config.engines) {
+                CaseResult r = measureCase(engine, size, config);
+                all_ok = all_ok && r.ok;
+                double rate = r.wall_seconds > 0 ? r.processes / r.wall_seconds : 0.0;
+                std::cout << (first ? "\n" : ",\n")
+                          << "    {\"engine\": \"" << engine << "\", \"processes\": " << size
+                          << ", \"ok\": " << (r.ok ? "true" : "false")
+                          << ", \"wall_ms\": " << r.wall_seconds * 1000
+                          << ", \"processes_per_sec\": " << std::setprecision(0) << rate << std::setprecision(3)
+                          << ", \"peak_rss_kb\": " << r.peak_rss_kb
+                          << ", \"avg_waiting\": " << r.avg_waiting
+                          << ", \"avg_turnaround\": " << r.avg_turnaround
+                          << ", \"makespan\": " << r.makespan << "}";
+                std::cout.flush();
+                first = false;
+            }
+        }
+        std::cout << "\n  ]\n}\n";
+        return all_ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+}
@@ -11,6 +11,23 @@
 #include <atomic>
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <climits>
+#include <future>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 class ThreadInfo {
 public:
@@ -130,6 +147,270 @@ public:
     }
 };
 
+// Move-only unit of work for PriorityThreadPool. The queues hold it by
+// unique_ptr, so dispatch moves a pointer instead of copying ThreadInfo.
+class PriorityTask {
+public:
+    ThreadInfo info;
+    std::function<void()> work;  // empty: simulate burst_time like ThreadScheduler
+    long long key = 0;           // aging key, see PriorityThreadPool
+    unsigned long long seq = 0;  // FIFO among equal keys
+    
+    explicit PriorityTask(ThreadInfo thread_info, std::function<void()> fn = nullptr)
+        : info(std::move(thread_info)), work(std::move(fn)) {}
+    
+    PriorityTask(const PriorityTask&) = delete;
+    PriorityTask& operator=(const PriorityTask&) = delete;
+    PriorityTask(PriorityTask&&) = default;
+    PriorityTask& operator=(PriorityTask&&) = default;
+};
+
+// N-worker priority scheduler over a MultiQueue: one small heap per worker,
+// each behind its own mutex. Producers push into a random heap; workers
+// read every heap's cached top key without locking and lock only the best
+// one, so concurrent pops rarely meet on the same mutex. Order is exact
+// when idle and relaxed only by pops racing each other. Priorities age linearly: a task's key is
+// arrival_ms - priority * aging_interval, which ranks it exactly as
+// "priority + waited / aging_interval" would at any instant, so a task
+// waiting one interval per level overtakes later higher-priority work
+// without any periodic re-sorting.
+class PriorityThreadPool {
+private:
+    static constexpr int TRY_LOCK_ATTEMPTS = 4; // before blocking on a heap's mutex
+    
+    struct SubQueue {
+        std::mutex mtx;
+        std::vector<std::unique_ptr<PriorityTask>> heap; // min-heap on (key, seq)
+        alignas(64) std::atomic<long long> top_key{LLONG_MAX}; // peeked without the lock
+    };
+    
+    std::vector<std::unique_ptr<SubQueue>> queues;
+    std::vector<std::thread> workers;
+    std::chrono::milliseconds aging_interval;
+    std::chrono::steady_clock::time_point epoch;
+    std::atomic<unsigned long long> next_seq{0};
+    std::atomic<long> queued{0};
+    std::atomic<int> sleepers{0};
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+    std::atomic<bool> running{true};
+    std::atomic<int> submitted_threads{0};
+    std::atomic<int> completed_threads{0};
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    
+    static bool later(const std::unique_ptr<PriorityTask>& a, const std::unique_ptr<PriorityTask>& b) {
+        return a->key != b->key ? a->key > b->key : a->seq > b->seq;
+    }
+    
+    static unsigned randomIndex(unsigned bound) {
+        thread_local std::minstd_rand rng(static_cast<unsigned>(
+            std::hash<std::thread::id>()(std::this_thread::get_id())));
+        return rng() % bound;
+    }
+    
+    std::unique_ptr<PriorityTask> popFrom(SubQueue& q) {
+        std::pop_heap(q.heap.begin(), q.heap.end(), later);
+        std::unique_ptr<PriorityTask> task = std::move(q.heap.back());
+        q.heap.pop_back();
+        q.top_key.store(q.heap.empty() ? LLONG_MAX : q.heap.front()->key, std::memory_order_release);
+        return task;
+    }
+    
+    // Heap with the smallest cached top key, nullptr when all are empty.
+    // The scan starts at a random heap so ties spread across workers.
+    SubQueue* bestQueue() {
+        size_t n = queues.size();
+        size_t first = randomIndex(static_cast<unsigned>(n));
+        SubQueue* best = nullptr;
+        long long best_key = LLONG_MAX;
+        for (size_t i = 0; i < n; i++) {
+            SubQueue* q = queues[(first + i) % n].get();
+            long long key = q->top_key.load(std::memory_order_acquire);
+            if (key < best_key) {
+                best_key = key;
+                best = q;
+            }
+        }
+        return best;
+    }
+    
+    std::unique_ptr<PriorityTask> tryPop() {
+        for (int attempt = 0; attempt < TRY_LOCK_ATTEMPTS; attempt++) {
+            SubQueue* best = bestQueue();
+            if (best == nullptr) return nullptr;
+            
+            std::unique_lock<std::mutex> lock(best->mtx, std::try_to_lock);
+            if (lock.owns_lock() && !best->heap.empty()) {
+                return popFrom(*best);
+            }
+        }
+        
+        // Kept losing races: wait for the best heap's lock instead, and
+        // rescan if another worker emptied it first. Only returns nullptr
+        // once every heap is empty.
+        for (;;) {
+            SubQueue* best = bestQueue();
+            if (best == nullptr) return nullptr;
+            
+            std::lock_guard<std::mutex> lock(best->mtx);
+            if (!best->heap.empty()) return popFrom(*best);
+        }
+    }
+    
+    void execute(int worker_id, PriorityTask& task) {
+        ThreadInfo& info = task.info;
+        info.start_time = std::chrono::steady_clock::now();
+        
+        if (task.work) {
+            task.work();
+            info.completion_time = std::chrono::steady_clock::now();
+        } else {
+            auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(info.start_time - info.arrival_time);
+            std::ostringstream line;
+            line << "Worker " << worker_id << " executing Thread " << info.thread_id
+                 << " (Priority: " << info.priority << ", Waited: " << waited.count() << "ms)\n";
+            std::cout << line.str();
+            
+            std::this_thread::sleep_for(std::chrono::milliseconds(info.burst_time * 100));
+            info.completion_time = std::chrono::steady_clock::now();
+            
+            auto turnaround_time = std::chrono::duration_cast<std::chrono::milliseconds>
+                (info.completion_time - info.arrival_time);
+            line.str("");
+            line << "Thread " << info.thread_id << " completed. Turnaround time: " << turnaround_time.count() << "ms\n";
+            std::cout << line.str();
+        }
+        
+        if (completed_threads.fetch_add(1) + 1 == submitted_threads.load()) {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            done_cv.notify_all();
+        }
+    }
+    
+    void worker(int worker_id) {
+        while (true) {
+            std::unique_ptr<PriorityTask> task = tryPop();
+            if (task) {
+                queued--;
+                execute(worker_id, *task);
+                continue;
+            }
+            
+            std::unique_lock<std::mutex> lock(idle_mutex);
+            sleepers++;
+            idle_cv.wait(lock, [this] { return queued.load() > 0 || !running.load(); });
+            sleepers--;
+            if (!running.load() && queued.load() == 0) break;
+        }
+    }
+    
+public:
+    explicit PriorityThreadPool(int num_workers,
+                                std::chrono::milliseconds aging = std::chrono::milliseconds(200))
+        : aging_interval(aging), epoch(std::chrono::steady_clock::now()) {
+        num_workers = std::max(1, num_workers);
+        for (int i = 0; i < num_workers; i++) {
+            queues.push_back(std::make_unique<SubQueue>());
+        }
+    }
+    
+    // Launch the workers; tasks added before this are dispatched together
+    void start() {
+        for (size_t i = workers.size(); i < queues.size(); i++) {
+            workers.emplace_back(&PriorityThreadPool::worker, this, static_cast<int>(i));
+        }
+    }
+    
+    ~PriorityThreadPool() {
+        stop();
+    }
+    
+    PriorityThreadPool(const PriorityThreadPool&) = delete;
+    PriorityThreadPool& operator=(const PriorityThreadPool&) = delete;
+    
+    void addTask(std::unique_ptr<PriorityTask> task) {
+        auto arrival = std::chrono::duration_cast<std::chrono::milliseconds>(task->info.arrival_time - epoch);
+        task->key = arrival.count() - static_cast<long long>(task->info.priority) * aging_interval.count();
+        task->seq = next_seq.fetch_add(1, std::memory_order_relaxed);
+        submitted_threads++;
+        
+        // A few random heaps without waiting, then block on the last one
+        unsigned n = static_cast<unsigned>(queues.size());
+        for (int attempt = 0;; attempt++) {
+            SubQueue& q = *queues[randomIndex(n)];
+            std::unique_lock<std::mutex> lock(q.mtx, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                if (attempt + 1 < TRY_LOCK_ATTEMPTS) continue;
+                lock.lock();
+            }
+            q.heap.push_back(std::move(task));
+            std::push_heap(q.heap.begin(), q.heap.end(), later);
+            q.top_key.store(q.heap.front()->key, std::memory_order_release);
+            break;
+        }
+        
+        // queued rises before we read sleepers, and worker() bumps sleepers
+        // before its wait predicate reads queued: either we notify it or it
+        // finds this task and does not sleep
+        queued++;
+        if (sleepers.load() > 0) {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            idle_cv.notify_one();
+        }
+    }
+    
+    void addThread(ThreadInfo thread_info, std::function<void()> work = nullptr) {
+        addTask(std::make_unique<PriorityTask>(std::move(thread_info), std::move(work)));
+    }
+    
+    void waitForCompletion() {
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done_cv.wait(lock, [this] { return completed_threads.load() >= submitted_threads.load(); });
+    }
+    
+    // Workers drain everything already queued before exiting
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            running.store(false);
+        }
+        idle_cv.notify_all();
+        for (auto& w : workers) {
+            if (w.joinable()) w.join();
+        }
+    }
+    
+    int getCompletedThreadsCount() const {
+        return completed_threads.load();
+    }
+    
+    int getSubmittedThreadsCount() const {
+        return submitted_threads.load();
+    }
+};
+
+// Dispatch throughput with empty tasks, so the numbers measure the queue
+// rather than the work; tasks are submitted from the calling thread
+void runPoolBenchmark(int tasks) {
+    std::cout << "=== PRIORITY POOL DISPATCH BENCHMARK (" << tasks << " tasks) ===\n";
+    int max_workers = std::max(8, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int workers = 1; workers <= max_workers; workers *= 2) {
+        std::atomic<long> sink{0};
+        auto start = std::chrono::steady_clock::now();
+        {
+            PriorityThreadPool pool(workers);
+            pool.start();
+            for (int i = 0; i < tasks; i++) {
+                pool.addThread(ThreadInfo(i, i % 8, 0), [&sink] { sink.fetch_add(1, std::memory_order_relaxed); });
+            }
+            pool.waitForCompletion();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Workers: " << workers << ", " << tasks / seconds / 1e6 << " M tasks/s\n";
+    }
+}
+
 // Pthread-style thread attributes simulation with custom enum names
 class ThreadAttributes {
 public:
@@ -139,11 +420,15 @@ public:
     
     SchedulingPolicy policy = POLICY_OTHER;
     ContentionScope scope = SCOPE_SYSTEM;
-    int priority = 0;
+    int priority = 0;               // real-time priority for FIFO/RR
+    int nice_value = 0;             // applied under POLICY_OTHER
+    std::vector<int> cpu_affinity;  // empty: any CPU
     
     void setSchedulingPolicy(SchedulingPolicy pol) { policy = pol; }
     void setContentionScope(ContentionScope sc) { scope = sc; }
     void setPriority(int prio) { priority = prio; }
+    void setNice(int nice) { nice_value = nice; }
+    void setAffinity(std::vector<int> cpus) { cpu_affinity = std::move(cpus); }
     
     void displayAttributes() const {
         std::cout << "Thread Attributes:\n";
@@ -151,9 +436,177 @@ public:
                                     policy == POLICY_RR ? "Round Robin" : "Other") << "\n";
         std::cout << "  Scope: " << (scope == SCOPE_PROCESS ? "Process" : "System") << "\n";
         std::cout << "  Priority: " << priority << "\n";
+        std::cout << "  Nice: " << nice_value << "\n";
+        std::cout << "  Affinity: ";
+        if (cpu_affinity.empty()) {
+            std::cout << "any CPU";
+        }
+        for (size_t i = 0; i < cpu_affinity.size(); i++) {
+            std::cout << (i ? ", " : "") << cpu_affinity[i];
+        }
+        std::cout << "\n";
+    }
+    
+    // What applyToCurrentThread() managed to do. Anything that was refused
+    // (no CAP_SYS_NICE, RLIMIT_RTPRIO of 0, CPUs outside the cpuset) is
+    // skipped, the thread keeps running under its old settings and the
+    // reason is recorded in 'notes'.
+    struct Applied {
+        bool policy = false;
+        bool nice = false;
+        bool affinity = false;
+        bool nice_requested = false;     // only under POLICY_OTHER
+        bool affinity_requested = false;
+        std::string notes;
+        
+        void display() const {
+            std::cout << "Applied: policy " << (policy ? "yes" : "no");
+            if (nice_requested) std::cout << ", nice " << (nice ? "yes" : "no");
+            if (affinity_requested) std::cout << ", affinity " << (affinity ? "yes" : "no");
+            std::cout << "\n";
+            if (!notes.empty()) std::cout << notes;
+        }
+    };
+    
+    Applied applyToCurrentThread() const {
+        Applied applied;
+        applied.nice_requested = (policy == POLICY_OTHER);
+        applied.affinity_requested = !cpu_affinity.empty();
+#if defined(__linux__)
+        if (scope == SCOPE_PROCESS) {
+            applied.notes += "  Note: Linux only supports system contention scope\n";
+        }
+        
+        if (policy == POLICY_FIFO || policy == POLICY_RR) {
+            int os_policy = (policy == POLICY_FIFO) ? SCHED_FIFO : SCHED_RR;
+            sched_param param{};
+            param.sched_priority = std::clamp(priority, sched_get_priority_min(os_policy),
+                                              sched_get_priority_max(os_policy));
+            int err = pthread_setschedparam(pthread_self(), os_policy, &param);
+            applied.policy = (err == 0);
+            if (err != 0) {
+                applied.notes += std::string("  Note: real-time policy refused (") + std::strerror(err) +
+                                 "), staying on SCHED_OTHER\n";
+            }
+        } else {
+            sched_param param{};
+            applied.policy = (pthread_setschedparam(pthread_self(), SCHED_OTHER, &param) == 0);
+            
+            // On Linux the nice value is per thread when addressed by tid
+            errno = 0;
+            int tid = static_cast<int>(syscall(SYS_gettid));
+            applied.nice = (setpriority(PRIO_PROCESS, tid, nice_value) == 0);
+            if (!applied.nice) {
+                applied.notes += std::string("  Note: nice ") + std::to_string(nice_value) +
+                                 " refused (" + std::strerror(errno) + ")\n";
+            }
+        }
+        
+        if (!cpu_affinity.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : cpu_affinity) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+            }
+            applied.affinity = (sched_setaffinity(0, sizeof(set), &set) == 0);
+            if (!applied.affinity) {
+                applied.notes += std::string("  Note: affinity refused (") + std::strerror(errno) + ")\n";
+            }
+        }
+#else
+        applied.notes += "  Note: scheduling attributes are only applied on Linux\n";
+#endif
+        return applied;
     }
 };
 
+// Start a std::thread that applies 'attr' to itself before running 'fn'.
+// Returns once the attributes are in place, reporting what was applied.
+template <typename Fn>
+std::thread launchWithAttributes(const ThreadAttributes& attr, Fn fn, ThreadAttributes::Applied* applied = nullptr) {
+    std::promise<ThreadAttributes::Applied> ready;
+    std::future<ThreadAttributes::Applied> result = ready.get_future();
+    // The thread owns the promise, so nothing it touches lives on our stack
+    std::thread thread([attr, fn = std::move(fn), ready = std::move(ready)]() mutable {
+        ready.set_value(attr.applyToCurrentThread());
+        fn();
+    });
+    ThreadAttributes::Applied outcome = result.get();
+    if (applied != nullptr) *applied = outcome;
+    return thread;
+}
+
+// Timer wakeup latency under each policy: a thread sleeps to an absolute
+// deadline every period_us and records how late it woke. Optional
+// SCHED_OTHER spinner threads compete for the CPUs, which is where
+// real-time policies should pull ahead.
+void runWakeupLatencyBenchmark(int iterations, int period_us, int load_threads) {
+    std::cout << "=== WAKEUP LATENCY BENCHMARK (" << iterations << " wakeups, " << period_us
+              << "us period, " << load_threads << " load threads) ===\n";
+    
+    std::atomic<bool> loaded{true};
+    std::vector<std::thread> load;
+    for (int i = 0; i < load_threads; i++) {
+        load.emplace_back([&loaded] {
+            volatile unsigned long spin = 0;
+            while (loaded.load(std::memory_order_relaxed)) spin++;
+        });
+    }
+    
+    struct Case {
+        const char* name;
+        ThreadAttributes::SchedulingPolicy policy;
+    };
+    const Case cases[] = {
+        {"SCHED_OTHER", ThreadAttributes::POLICY_OTHER},
+        {"SCHED_FIFO", ThreadAttributes::POLICY_FIFO},
+        {"SCHED_RR", ThreadAttributes::POLICY_RR},
+    };
+    
+    std::cout << std::left << std::setw(13) << "Policy" << std::right
+              << std::setw(10) << "min" << std::setw(10) << "avg" << std::setw(10) << "p50"
+              << std::setw(10) << "p99" << std::setw(10) << "max" << std::setw(10) << "jitter"
+              << "  (us)\n";
+    
+    for (const Case& c : cases) {
+        ThreadAttributes attr;
+        attr.setSchedulingPolicy(c.policy);
+        attr.setPriority(50);
+        
+        std::vector<double> late_us;
+        late_us.reserve(iterations);
+        ThreadAttributes::Applied applied;
+        std::thread probe = launchWithAttributes(attr, [&] {
+            using Clock = std::chrono::steady_clock;
+            auto deadline = Clock::now();
+            for (int i = 0; i < iterations; i++) {
+                deadline += std::chrono::microseconds(period_us);
+                std::this_thread::sleep_until(deadline);
+                late_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - deadline).count());
+            }
+        }, &applied);
+        probe.join();
+        
+        std::sort(late_us.begin(), late_us.end());
+        double sum = 0;
+        for (double v : late_us) sum += v;
+        double mean = sum / late_us.size();
+        double var = 0;
+        for (double v : late_us) var += (v - mean) * (v - mean);
+        auto at = [&](double q) { return late_us[static_cast<size_t>(q * (late_us.size() - 1))]; };
+        
+        std::cout << std::left << std::setw(13) << c.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << late_us.front() << std::setw(10) << mean
+                  << std::setw(10) << at(0.50) << std::setw(10) << at(0.99)
+                  << std::setw(10) << late_us.back() << std::setw(10) << std::sqrt(var / late_us.size())
+                  << (c.policy != ThreadAttributes::POLICY_OTHER && !applied.policy ? "  (fell back to SCHED_OTHER)" : "")
+                  << "\n";
+    }
+    
+    loaded = false;
+    for (auto& t : load) t.join();
+}
+
 // Demo worker thread function
 void workerThread(int id, int work_time) {
     std::cout << "Worker Thread " << id << " starting work for " << work_time << "ms\n";
@@ -161,8 +614,23 @@ void workerThread(int id, int work_time) {
     std::cout << "Worker Thread " << id << " completed work\n";
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        if (argc >= 2 && std::string(argv[1]) == "--bench") {
+            // Usage: --bench [TASKS]
+            runPoolBenchmark(argc >= 3 ? std::max(1, std::atoi(argv[2])) : 200000);
+            return 0;
+        }
+        if (argc >= 2 && std::string(argv[1]) == "--latency") {
+            // Usage: --latency [ITERATIONS] [PERIOD_US] [LOAD_THREADS]
+            int iterations = argc >= 3 ? std::max(1, std::atoi(argv[2])) : 2000;
+            int period_us = argc >= 4 ? std::max(1, std::atoi(argv[3])) : 1000;
+            int load_threads = argc >= 5 ? std::max(0, std::atoi(argv[4]))
+                                         : static_cast<int>(std::thread::hardware_concurrency());
+            runWakeupLatencyBenchmark(iterations, period_us, load_threads);
+            return 0;
+        }
+        
         std::cout << "=== THREAD SCHEDULING DEMONSTRATION ===\n\n";
         
         // Demonstrate thread attributes
@@ -194,13 +662,40 @@ int main() {
             scheduler_thread.join();
         }
         
+        std::cout << "\n=== MULTI-WORKER PRIORITY SCHEDULER ===\n";
+        
+        // Two workers, priorities aging one level per 200ms of waiting
+        PriorityThreadPool pool(2, std::chrono::milliseconds(200));
+        pool.addThread(ThreadInfo(5, 1, 3));  // Low priority, ages while it waits
+        pool.addThread(ThreadInfo(6, 5, 2));  // High priority
+        pool.addThread(ThreadInfo(7, 3, 2));  // Medium priority
+        pool.addThread(ThreadInfo(8, 5, 3));  // High priority
+        pool.addThread(ThreadInfo(9, 4, 2));  // Medium-high priority
+        pool.addThread(ThreadInfo(10, 5, 2)); // High priority
+        pool.start();
+        
+        // Arrives 300ms later with a higher priority than Thread 5, but
+        // Thread 5 has aged past it by then
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        pool.addThread(ThreadInfo(11, 2, 1));
+        pool.waitForCompletion();
+        pool.stop();
+        std::cout << "Pool processed " << pool.getCompletedThreadsCount() << " threads.\n";
+        
         std::cout << "\n=== PTHREAD STYLE THREADS ===\n";
         
         // Create multiple worker threads
         std::vector<std::thread> workers;
         
+        // Worker 1 runs under the attributes shown above; the rest use defaults
         for (int i = 1; i <= 4; i++) {
-            workers.emplace_back(workerThread, i, i * 200);
+            if (i == 1) {
+                ThreadAttributes::Applied applied;
+                workers.push_back(launchWithAttributes(attr, [] { workerThread(1, 200); }, &applied));
+                applied.display();
+            } else {
+                workers.emplace_back(workerThread, i, i * 200);
+            }
         }
         
         // Wait for all workers to complete
@@ -11,6 +11,13 @@
 #include <mutex>
 #include <condition_variable>
 #include <random>
+#include <string>
+#include <cstdlib>
+
+#include "../common/spin_wait.h"
+#include "../common/semaphore.h"
+#include "../common/mpmc_queue.h"
+#include "../common/spsc_queue.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -19,14 +26,17 @@ using namespace std::chrono;
 // CUSTOM SEMAPHORE IMPLEMENTATION FOR C++17
 //=============================================================================
 
-class Semaphore {
+// Semaphore itself comes from common/semaphore.h (atomic fast path, futex
+// parking). This is the textbook mutex + condition variable version it
+// replaced, kept to compare the two in SemaphoreDemo::benchmark_fast_path().
+class CondVarSemaphore {
 private:
     mutex mtx;
     condition_variable cv;
     int count;
 
 public:
-    explicit Semaphore(int initial_count) : count(initial_count) {}
+    explicit CondVarSemaphore(int initial_count) : count(initial_count) {}
 
     void acquire() {
         unique_lock<mutex> lock(mtx);
@@ -305,6 +315,56 @@ public:
         
         cout << "All processes completed!" << endl;
     }
+    
+    // Cost of an uncontended acquire/release pair, then a two-thread
+    // ping-pong where every acquire has to wait for the other side
+    static void benchmark_fast_path() {
+        cout << "\n=== SEMAPHORE FAST PATH BENCHMARK ===" << endl;
+        const int ITERATIONS = 2000000;
+        const int ROUNDS = 20000;
+        
+        auto uncontended = [&](auto& sem) {
+            auto start = steady_clock::now();
+            for (int i = 0; i < ITERATIONS; ++i) {
+                sem.acquire();
+                sem.release();
+            }
+            return duration<double, nano>(steady_clock::now() - start).count() / ITERATIONS;
+        };
+        
+        auto ping_pong = [&](auto& ping, auto& pong) {
+            auto start = steady_clock::now();
+            thread partner([&] {
+                for (int i = 0; i < ROUNDS; ++i) {
+                    ping.acquire();
+                    pong.release();
+                }
+            });
+            for (int i = 0; i < ROUNDS; ++i) {
+                ping.release();
+                pong.acquire();
+            }
+            partner.join();
+            return duration<double, micro>(steady_clock::now() - start).count() / ROUNDS;
+        };
+        
+        CondVarSemaphore cv_sem(1), cv_ping(0), cv_pong(0);
+        Semaphore fast_sem(1), fast_ping(0), fast_pong(0);
+        
+        cout << "Uncontended acquire+release: condvar " << uncontended(cv_sem)
+             << " ns, futex " << uncontended(fast_sem) << " ns" << endl;
+        cout << "Ping-pong round trip: condvar " << ping_pong(cv_ping, cv_pong)
+             << " us, futex " << ping_pong(fast_ping, fast_pong) << " us" << endl;
+        
+        // Timed acquire and batch release
+        Semaphore gate(0);
+        bool timed_out = !gate.try_acquire_for(milliseconds(20));
+        gate.release(3);
+        int taken = 0;
+        while (gate.try_acquire()) ++taken;
+        cout << "try_acquire_for on empty semaphore timed out: " << (timed_out ? "yes" : "no")
+             << ", permits from release(3): " << taken << endl;
+    }
 };
 
 Semaphore SemaphoreDemo::resource_semaphore{3}; // 3 resources available
@@ -313,14 +373,56 @@ Semaphore SemaphoreDemo::resource_semaphore{3}; // 3 resources available
 // 6. PRODUCER-CONSUMER PROBLEM (Sections 6.1, 6.6)
 //=============================================================================
 
+// The classic bounded buffer: a circular array behind one mutex and two
+// condition variables. ProducerConsumer now uses BlockingMPMCQueue from
+// common/mpmc_queue.h; this version stays as the baseline it is measured
+// against in ProducerConsumer::benchmark_throughput().
+template <typename T>
+class MutexBoundedBuffer {
+private:
+    mutex mtx;
+    condition_variable not_empty, not_full;
+    vector<T> items;
+    size_t in = 0, out = 0, count = 0;
+    bool closed = false;
+    
+public:
+    explicit MutexBoundedBuffer(size_t capacity) : items(capacity) {}
+    
+    bool push(const T& item) {
+        unique_lock<mutex> lock(mtx);
+        not_full.wait(lock, [this] { return count < items.size() || closed; });
+        if (closed) return false;
+        items[in] = item;
+        in = (in + 1) % items.size();
+        count++;
+        not_empty.notify_one();
+        return true;
+    }
+    
+    bool pop(T& item) {
+        unique_lock<mutex> lock(mtx);
+        not_empty.wait(lock, [this] { return count > 0 || closed; });
+        if (count == 0) return false;
+        item = items[out];
+        out = (out + 1) % items.size();
+        count--;
+        not_full.notify_one();
+        return true;
+    }
+    
+    void close() {
+        lock_guard<mutex> lock(mtx);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+};
+
 class ProducerConsumer {
 private:
     static const int BUFFER_SIZE = 10;
-    static int buffer[BUFFER_SIZE];
-    static int in, out, count;
-    static mutex buffer_mutex;
-    static condition_variable not_empty, not_full;
-    static bool done;
+    static BlockingMPMCQueue<int> buffer; // lock-free slots; threads park only when full or empty
     
 public:
     static void producer(int producer_id) {
@@ -331,40 +433,18 @@ public:
         for (int i = 0; i < 5; ++i) {
             int item = dis(gen);
             
-            unique_lock<mutex> lock(buffer_mutex);
-            not_full.wait(lock, []{ return count < BUFFER_SIZE; });
-            
-            // Critical section
-            buffer[in] = item;
-            in = (in + 1) % BUFFER_SIZE;
-            count++;
-            
+            buffer.push(item); // waits while the buffer is full
             cout << "Producer " << producer_id << " produced: " << item << endl;
             
-            not_empty.notify_one();
-            lock.unlock();
-            
             this_thread::sleep_for(milliseconds(100));
         }
     }
     
     static void consumer(int consumer_id) {
         for (int i = 0; i < 5; ++i) {
-            unique_lock<mutex> lock(buffer_mutex);
-            not_empty.wait(lock, []{ return count > 0 || done; });
-            
-            if (count > 0) {
-                // Critical section
-                int item = buffer[out];
-                out = (out + 1) % BUFFER_SIZE;
-                count--;
-                
-                cout << "Consumer " << consumer_id << " consumed: " << item << endl;
-                
-                not_full.notify_one();
-            }
-            
-            lock.unlock();
+            int item;
+            if (!buffer.pop(item)) break; // waits while the buffer is empty
+            cout << "Consumer " << consumer_id << " consumed: " << item << endl;
             
             this_thread::sleep_for(milliseconds(150));
         }
@@ -373,9 +453,6 @@ public:
     static void demonstrate_producer_consumer() {
         cout << "\n=== PRODUCER-CONSUMER DEMONSTRATION ===" << endl;
         
-        in = out = count = 0;
-        done = false;
-        
         vector<thread> threads;
         
         // Create 2 producers and 2 consumers
@@ -388,21 +465,235 @@ public:
             t.join();
         }
         
-        done = true;
-        not_empty.notify_all();
-        
         cout << "Producer-Consumer demonstration completed!" << endl;
     }
+    
+    // Items per second through 'Buffer'. One thread alternates push and pop;
+    // more threads are split evenly into producers and consumers.
+    template <typename Buffer>
+    static double measure_throughput(int threads, long total_items) {
+        Buffer queue(1024);
+        auto start = steady_clock::now();
+        
+        if (threads == 1) {
+            for (long i = 0; i < total_items; ++i) {
+                int item;
+                queue.push(static_cast<int>(i));
+                queue.pop(item);
+            }
+        } else {
+            int producers = threads / 2;
+            int consumers = threads - producers;
+            long per_producer = total_items / producers;
+            vector<thread> producer_threads, consumer_threads;
+            
+            for (int c = 0; c < consumers; ++c) {
+                consumer_threads.emplace_back([&queue] {
+                    int item;
+                    while (queue.pop(item)) {}
+                });
+            }
+            for (int p = 0; p < producers; ++p) {
+                producer_threads.emplace_back([&queue, per_producer] {
+                    for (long i = 0; i < per_producer; ++i) {
+                        queue.push(static_cast<int>(i));
+                    }
+                });
+            }
+            for (auto& t : producer_threads) t.join();
+            queue.close(); // consumers drain what is left, then stop
+            for (auto& t : consumer_threads) t.join();
+            total_items = per_producer * producers;
+        }
+        
+        return total_items / duration<double>(steady_clock::now() - start).count();
+    }
+    
+    static void benchmark_throughput(long total_items) {
+        cout << "\n=== BOUNDED BUFFER THROUGHPUT (" << total_items << " items, capacity 1024, "
+             << thread::hardware_concurrency() << " hardware threads) ===" << endl;
+        cout << "Threads   mutex+condvar (M items/s)   MPMC queue (M items/s)" << endl;
+        for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+            double locked = measure_throughput<MutexBoundedBuffer<int>>(threads, total_items);
+            double lock_free = measure_throughput<BlockingMPMCQueue<int>>(threads, total_items);
+            cout << threads << "\t  " << locked / 1e6 << "\t\t\t      " << lock_free / 1e6 << endl;
+        }
+    }
 };
 
-int ProducerConsumer::buffer[ProducerConsumer::BUFFER_SIZE];
-int ProducerConsumer::in = 0;
-int ProducerConsumer::out = 0;
-int ProducerConsumer::count = 0;
-mutex ProducerConsumer::buffer_mutex;
-condition_variable ProducerConsumer::not_empty;
-condition_variable ProducerConsumer::not_full;
-bool ProducerConsumer::done = false;
+BlockingMPMCQueue<int> ProducerConsumer::buffer(ProducerConsumer::BUFFER_SIZE);
+
+//=============================================================================
+// 6b. PIPELINES OF SINGLE-PRODUCER SINGLE-CONSUMER STAGES
+//=============================================================================
+
+// A chain of threads where each stage reads one SPSCQueue (common/spsc_queue.h)
+// and writes the next, so every ring has exactly one producer and one
+// consumer. Stages move items in batches with pop_n/push_n; the ring itself
+// never blocks, so a stage with nothing to do backs off by itself.
+class Pipeline {
+private:
+    static constexpr size_t RING_CAPACITY = 1024;
+    static constexpr long END_OF_STREAM = -1;
+    
+    // Spin briefly, then give the CPU away (at once on a single CPU)
+    static void back_off(int& idle_rounds) {
+        if (spin_wait::spinningHelps() && ++idle_rounds < 64) return;
+        idle_rounds = 0;
+        this_thread::yield();
+    }
+    
+    template <typename Queue>
+    static void push_all(Queue& ring, const long* items, size_t count) {
+        int idle_rounds = 0;
+        while (count > 0) {
+            size_t pushed = ring.push_n(items, count);
+            if (pushed == 0) back_off(idle_rounds);
+            items += pushed;
+            count -= pushed;
+        }
+    }
+    
+    // Middle stage: apply 'transform' to every item until END_OF_STREAM
+    template <typename Transform>
+    static void stage(SPSCQueue<long>& in, SPSCQueue<long>& out, size_t batch, Transform transform) {
+        vector<long> items(batch);
+        int idle_rounds = 0;
+        for (;;) {
+            size_t count = in.pop_n(items.begin(), batch);
+            if (count == 0) {
+                back_off(idle_rounds);
+                continue;
+            }
+            bool done = items[count - 1] == END_OF_STREAM;
+            for (size_t i = 0; i < count - (done ? 1 : 0); ++i) {
+                items[i] = transform(items[i]);
+            }
+            push_all(out, items.data(), count);
+            if (done) return;
+        }
+    }
+    
+public:
+    struct Result {
+        long checksum;
+        double ns_per_item;
+    };
+    
+    // source -> square -> offset -> sink, three ring handoffs per item
+    static Result run(long items, size_t batch) {
+        SPSCQueue<long> raw(RING_CAPACITY), squared(RING_CAPACITY), shifted(RING_CAPACITY);
+        long checksum = 0;
+        auto start = steady_clock::now();
+        
+        thread source([&] {
+            vector<long> chunk;
+            chunk.reserve(batch);
+            for (long i = 0; i < items; ++i) {
+                chunk.push_back(i % 1000);
+                if (chunk.size() == batch) {
+                    push_all(raw, chunk.data(), chunk.size());
+                    chunk.clear();
+                }
+            }
+            chunk.push_back(END_OF_STREAM);
+            push_all(raw, chunk.data(), chunk.size());
+        });
+        thread square([&] { stage(raw, squared, batch, [](long x) { return x * x; }); });
+        thread offset([&] { stage(squared, shifted, batch, [](long x) { return x + 1; }); });
+        thread sink([&] {
+            vector<long> chunk(batch);
+            int idle_rounds = 0;
+            for (;;) {
+                size_t count = shifted.pop_n(chunk.begin(), batch);
+                if (count == 0) {
+                    back_off(idle_rounds);
+                    continue;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    if (chunk[i] == END_OF_STREAM) return;
+                    checksum += chunk[i];
+                }
+            }
+        });
+        
+        source.join();
+        square.join();
+        offset.join();
+        sink.join();
+        double ns = duration<double, nano>(steady_clock::now() - start).count();
+        return {checksum, ns / items};
+    }
+    
+    static void demonstrate_pipeline() {
+        cout << "\n=== SPSC PIPELINE DEMONSTRATION ===" << endl;
+        const long ITEMS = 1000000;
+        long expected = 0;
+        for (long i = 0; i < ITEMS; ++i) expected += (i % 1000) * (i % 1000) + 1;
+        
+        Result r = run(ITEMS, 64);
+        cout << "4 stages, " << ITEMS << " items in batches of 64: checksum "
+             << (r.checksum == expected ? "OK" : "MISMATCH") << ", " << r.ns_per_item
+             << " ns per item end to end" << endl;
+    }
+    
+    // Two-thread handoff cost per item for each queue; the batched SPSC rows
+    // use push_n/pop_n, the others move one item per call
+    static void benchmark_handoff(long items) {
+        cout << "\n=== STAGE HANDOFF COST (" << items << " items, 2 threads, "
+             << thread::hardware_concurrency() << " hardware threads) ===" << endl;
+        
+        auto report = [&](const char* name, steady_clock::time_point start, long sum) {
+            double ns = duration<double, nano>(steady_clock::now() - start).count() / items;
+            long expected = items * (items - 1) / 2;
+            cout << name << ": " << ns << " ns/item" << (sum == expected ? "" : " (CHECKSUM MISMATCH)") << endl;
+        };
+        
+        for (size_t batch : {size_t(1), size_t(16), size_t(64), size_t(256)}) {
+            SPSCQueue<long> ring(RING_CAPACITY);
+            long sum = 0;
+            auto start = steady_clock::now();
+            thread consumer([&] {
+                vector<long> chunk(batch);
+                int idle_rounds = 0;
+                for (long seen = 0; seen < items;) {
+                    size_t count = ring.pop_n(chunk.begin(), batch);
+                    if (count == 0) back_off(idle_rounds);
+                    for (size_t i = 0; i < count; ++i) sum += chunk[i];
+                    seen += count;
+                }
+            });
+            vector<long> chunk(batch);
+            for (long i = 0; i < items; i += batch) {
+                size_t count = static_cast<size_t>(min<long>(batch, items - i));
+                for (size_t k = 0; k < count; ++k) chunk[k] = i + k;
+                push_all(ring, chunk.data(), count);
+            }
+            consumer.join();
+            string name = "SPSC ring, batch " + to_string(batch);
+            report(name.c_str(), start, sum);
+        }
+        
+        auto per_item = [&](const char* name, auto& queue) {
+            long sum = 0;
+            auto start = steady_clock::now();
+            thread consumer([&] {
+                int item = 0;
+                for (long seen = 0; seen < items; ++seen) {
+                    queue.pop(item);
+                    sum += item;
+                }
+            });
+            for (long i = 0; i < items; ++i) queue.push(static_cast<int>(i));
+            consumer.join();
+            report(name, start, sum);
+        };
+        BlockingMPMCQueue<int> mpmc(RING_CAPACITY);
+        per_item("MPMC queue", mpmc);
+        MutexBoundedBuffer<int> locked(RING_CAPACITY);
+        per_item("mutex+condvar buffer", locked);
+    }
+};
 
 //=============================================================================
 // 7. MONITOR IMPLEMENTATION (Section 6.7)
@@ -553,7 +844,22 @@ mutex DiningPhilosophers::chopsticks[DiningPhilosophers::NUM_PHILOSOPHERS];
 // MAIN FUNCTION - RUN ALL DEMONSTRATIONS
 //=============================================================================
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && string(argv[1]) == "--semaphore-bench") {
+        SemaphoreDemo::benchmark_fast_path();
+        return 0;
+    }
+    if (argc >= 2 && string(argv[1]) == "--buffer-bench") {
+        // Usage: --buffer-bench [ITEMS]
+        ProducerConsumer::benchmark_throughput(argc >= 3 ? max(1L, atol(argv[2])) : 2000000L);
+        return 0;
+    }
+    if (argc >= 2 && string(argv[1]) == "--pipeline-bench") {
+        // Usage: --pipeline-bench [ITEMS]
+        Pipeline::benchmark_handoff(argc >= 3 ? max(1L, atol(argv[2])) : 10000000L);
+        return 0;
+    }
+    
     cout << "CHAPTER 6: SYNCHRONIZATION TOOLS - C++17 IMPLEMENTATION" << endl;
     cout << "========================================================" << endl;
     
@@ -576,6 +882,7 @@ int main() {
         
         // 6. Producer-Consumer Problem
         ProducerConsumer::demonstrate_producer_consumer();
+        Pipeline::demonstrate_pipeline();
         
         // 7. Monitor
         ResourceAllocator::demonstrate_monitor();
@@ -602,6 +909,15 @@ int main() {
  * For C++20 (if available):
  * g++ -std=c++20 -pthread synchronization_tools.cpp -o synchronization_tools
  * 
+ * Semaphore acquire/release cost and ping-pong latency, condvar vs futex:
+ * ./synchronization_tools --semaphore-bench
+ * 
+ * Bounded buffer throughput, mutex+condvar vs lock-free MPMC, 1-64 threads:
+ * ./synchronization_tools --buffer-bench [ITEMS]
+ * 
+ * Per-item handoff cost between two pipeline stages (SPSC ring, batched):
+ * ./synchronization_tools --pipeline-bench [ITEMS]
+ * 
  * LEARNING OBJECTIVES:
  * After studying this code, students should understand:
  * 1. How race conditions occur and their consequences
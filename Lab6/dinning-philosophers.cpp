@@ -7,43 +7,12 @@
 #include <condition_variable>
 #include <atomic>
 
+// Semaphore: atomic fast path with futex parking, shared with Lab5
+#include "../common/semaphore.h"
+
 using namespace std;
 using namespace std::chrono;
 
-//=============================================================================
-// CUSTOM SEMAPHORE IMPLEMENTATION (for C++11/14/17 compatibility)
-//=============================================================================
-class Semaphore {
-private:
-    mutex mtx;
-    condition_variable cv;
-    int count;
-    
-public:
-    explicit Semaphore(int initial_count) : count(initial_count) {}
-    
-    void acquire() {
-        unique_lock<mutex> lock(mtx);
-        cv.wait(lock, [this] { return count > 0; });
-        --count;
-    }
-    
-    void release() {
-        lock_guard<mutex> lock(mtx);
-        ++count;
-        cv.notify_one();
-    }
-    
-    bool try_acquire() {
-        lock_guard<mutex> lock(mtx);
-        if (count > 0) {
-            --count;
-            return true;
-        }
-        return false;
-    }
-};
-
 //=============================================================================
 // SOLUTION 1: SEMAPHORE-BASED APPROACH (Prevents Deadlock + Reduces Starvation)
 //=============================================================================
@@ -0,0 +1,278 @@
+/*
+ * Bounded multi-producer multi-consumer queue (Dmitry Vyukov's design) and
+ * a blocking wrapper around it.
+ *
+ * Every slot carries a sequence number that says whose turn it is: a
+ * producer may fill slot pos % capacity when its sequence equals pos, a
+ * consumer may empty it when the sequence equals pos + 1. Producers and
+ * consumers each claim positions with one CAS on their own counter, so the
+ * two sides never touch the same cache line unless the queue is nearly
+ * full or nearly empty, and no operation takes a lock.
+ *
+ * BlockingMPMCQueue only parks a thread when its side cannot make progress
+ * (full for producers, empty for consumers), on a futex event count on
+ * Linux and a condition variable elsewhere.
+ */
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "spin_wait.h"
+
+template <typename T>
+class MPMCQueue {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T* item() { return reinterpret_cast<T*>(&storage); }
+    };
+
+    const size_t capacity_;
+    const size_t mask; // capacity - 1 when capacity is a power of two, else 0
+    std::unique_ptr<Cell[]> cells;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos{0};
+
+    size_t slot(size_t pos) const { return mask ? (pos & mask) : (pos % capacity_); }
+
+public:
+    // Any capacity works; powers of two index with a mask instead of a
+    // division. One slot cannot tell "full" from "empty", so the minimum is 2.
+    explicit MPMCQueue(size_t capacity)
+        : capacity_(capacity < 2 ? 2 : capacity),
+          mask((capacity_ & (capacity_ - 1)) == 0 ? capacity_ - 1 : 0),
+          cells(new Cell[capacity_]) {
+        for (size_t i = 0; i < capacity_; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Destroys items still queued; no other thread may be using the queue
+    ~MPMCQueue() {
+        size_t tail = enqueue_pos.load();
+        for (size_t pos = dequeue_pos.load(); pos != tail; pos++) {
+            cells[slot(pos)].item()->~T();
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    // Constructs the item in place; false if the queue is full
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[slot(pos)];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    new (cell.item()) T(std::forward<Args>(args)...);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // the slot still holds the item from one lap ago
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_push(const T& item) { return try_emplace(item); }
+    bool try_push(T&& item) { return try_emplace(std::move(item)); }
+
+    // Moves the oldest item into 'out'; false if the queue is empty
+    bool try_pop(T& out) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[slot(pos)];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* item = cell.item();
+                    out = std::move(*item);
+                    item->~T();
+                    cell.sequence.store(pos + capacity_, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // Approximate while producers or consumers are active
+    size_t size() const {
+        size_t head = dequeue_pos.load(std::memory_order_relaxed);
+        size_t tail = enqueue_pos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+};
+
+// Event count: a waiter snapshots the epoch with prepareWait(), re-checks its
+// condition, then sleeps only if nobody has called notify() since. notify()
+// is a fence and a load unless someone is actually waiting. Only one
+// single-thread wakeup is in flight at a time: until the woken thread runs,
+// further notify() calls return early instead of each making a syscall, and
+// the woken thread passes the wakeup on if there is still work (see
+// BlockingMPMCQueue).
+class EventCount {
+private:
+    std::atomic<int> epoch{0};
+    std::atomic<int> waiters{0};
+    std::atomic<bool> wake_pending{false};
+    spin_wait::Futex futex;
+
+    // Clearing is always safe: at worst it lets an extra wakeup through
+    void clearPending() {
+        if (wake_pending.load(std::memory_order_relaxed)) wake_pending.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+public:
+    int prepareWait() {
+        waiters.fetch_add(1);
+        return epoch.load();
+    }
+
+    void cancelWait() {
+        waiters.fetch_sub(1);
+        clearPending();
+    }
+
+    void wait(int observed) {
+        futex.wait(epoch, observed);
+        waiters.fetch_sub(1);
+        clearPending();
+    }
+
+    void notify(bool all = false) {
+        // Pairs with the RMW in prepareWait(): either the waiter sees our
+        // queue update on its re-check, or we see it registered here
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) == 0) return;
+        if (!all && (wake_pending.load(std::memory_order_relaxed) || wake_pending.exchange(true))) return;
+        epoch.fetch_add(1);
+        futex.wake(epoch, all ? INT_MAX : 1);
+    }
+};
+
+// Blocking producer/consumer queue. push() waits while the queue is full and
+// pop() while it is empty; after close(), push() fails and pop() drains
+// what is left and then returns false. A thread that had to sleep wakes the
+// next sleeper on its side when it finds more room or more items, since
+// notifications sent while its own wakeup was pending were folded into it.
+template <typename T>
+class BlockingMPMCQueue {
+private:
+    static constexpr int SPIN_TRIES = 64;
+
+    MPMCQueue<T> queue;
+    EventCount not_full;
+    EventCount not_empty;
+    std::atomic<bool> closed{false};
+
+    static int spinTries() { return spin_wait::spinningHelps() ? SPIN_TRIES : 0; }
+
+public:
+    explicit BlockingMPMCQueue(size_t capacity) : queue(capacity) {}
+
+    template <typename U>
+    bool push(U&& item) {
+        for (int i = 0; i < spinTries(); i++) {
+            if (closed.load(std::memory_order_relaxed)) return false;
+            if (queue.try_push(std::forward<U>(item))) {
+                not_empty.notify();
+                return true;
+            }
+            spin_wait::cpuRelax();
+        }
+        bool slept = false;
+        for (;;) {
+            if (closed.load()) return false;
+            if (queue.try_push(std::forward<U>(item))) break;
+            int epoch = not_full.prepareWait();
+            if (closed.load()) {
+                not_full.cancelWait();
+                return false;
+            }
+            if (queue.try_push(std::forward<U>(item))) {
+                not_full.cancelWait();
+                break;
+            }
+            not_full.wait(epoch);
+            slept = true;
+        }
+        not_empty.notify();
+        if (slept && queue.size() < queue.capacity()) not_full.notify();
+        return true;
+    }
+
+    bool pop(T& out) {
+        for (int i = 0; i < spinTries(); i++) {
+            if (queue.try_pop(out)) {
+                not_full.notify();
+                return true;
+            }
+            spin_wait::cpuRelax();
+        }
+        bool slept = false;
+        for (;;) {
+            if (queue.try_pop(out)) break;
+            int epoch = not_empty.prepareWait();
+            if (queue.try_pop(out)) {
+                not_empty.cancelWait();
+                break;
+            }
+            if (closed.load()) {
+                not_empty.cancelWait();
+                return queue.try_pop(out);
+            }
+            not_empty.wait(epoch);
+            slept = true;
+        }
+        not_full.notify();
+        if (slept && !queue.empty()) not_empty.notify();
+        return true;
+    }
+
+    bool try_push(const T& item) {
+        if (closed.load(std::memory_order_relaxed) || !queue.try_push(item)) return false;
+        not_empty.notify();
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        if (!queue.try_pop(out)) return false;
+        not_full.notify();
+        return true;
+    }
+
+    // Wake everyone; producers fail from now on, consumers drain and stop
+    void close() {
+        closed.store(true);
+        not_full.notify(true);
+        not_empty.notify(true);
+    }
+
+    size_t capacity() const { return queue.capacity(); }
+    size_t size() const { return queue.size(); }
+};
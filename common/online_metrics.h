@@ -0,0 +1,257 @@
+/*
+ * Online scheduling metrics, shared by the Lab4 programs.
+ *
+ * MetricsAccumulator folds completion events into running statistics
+ * (Welford mean and variance, min/max) and a fixed-size quantile sketch
+ * per metric. It costs O(1) per event and keeps no process list, so it
+ * can sit on the on_complete sink of a streaming scheduler for a replay
+ * of any length. OnlineMetrics adds a mutex, so one thread can record
+ * while another takes snapshots, e.g. a replay loop and a live dashboard.
+ */
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Welford's online mean and variance: one pass, numerically stable, O(1)
+// per sample and no stored samples
+class RunningStats {
+private:
+    long long count = 0;
+    double mean_value = 0;
+    double m2 = 0;
+    int min_value = INT_MAX;
+    int max_value = INT_MIN;
+
+public:
+    void add(int x) {
+        count++;
+        double delta = x - mean_value;
+        mean_value += delta / count;
+        m2 += delta * (x - mean_value);
+        min_value = std::min(min_value, x);
+        max_value = std::max(max_value, x);
+    }
+
+    long long size() const { return count; }
+    double mean() const { return mean_value; }
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    int min() const { return count ? min_value : 0; }
+    int max() const { return count ? max_value : 0; }
+};
+
+// Streaming quantile sketch over non-negative ints. Log-linear buckets:
+// values below SUB_BUCKETS are exact, larger ones are grouped by power of
+// two into SUB_BUCKETS steps, so any quantile is within 1% of the true
+// value while memory stays fixed however long the stream runs.
+class QuantileSketch {
+public:
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKETS = (31 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+private:
+    std::vector<long long> counts = std::vector<long long>(BUCKETS, 0);
+    long long total = 0;
+    int max_value = 0;
+
+    static int bucketOf(int value) {
+        if (value < SUB_BUCKETS) return value;
+        int msb = 31 - __builtin_clz(static_cast<unsigned>(value));
+        int shift = msb - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+    }
+
+    static long long highestIn(int bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        int shift = bucket / SUB_BUCKETS - 1;
+        long long sub = bucket % SUB_BUCKETS + SUB_BUCKETS;
+        return ((sub + 1) << shift) - 1;
+    }
+
+public:
+    void add(int value) {
+        value = std::max(0, value);
+        counts[bucketOf(value)]++;
+        total++;
+        max_value = std::max(max_value, value);
+    }
+
+    // Nearest-rank quantile, q in [0, 1]
+    int quantile(double q) const {
+        if (total == 0) return 0;
+        long long rank = std::max(1LL, static_cast<long long>(std::ceil(q * total)));
+        long long seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank) return static_cast<int>(std::min<long long>(highestIn(i), max_value));
+        }
+        return max_value;
+    }
+};
+
+// One finished process, as a scheduler or trace replay reports it.
+// response_time is first dispatch minus arrival; -1 if unknown.
+struct CompletionEvent {
+    int pid;
+    int arrival_time;
+    int burst_time;
+    int completion_time;
+    int response_time = -1;
+};
+
+class MetricsAccumulator {
+public:
+    struct Summary {
+        double mean = 0;
+        double stddev = 0;
+        int min = 0;
+        int max = 0;
+        int p50 = 0;
+        int p90 = 0;
+        int p99 = 0;
+    };
+
+    struct Snapshot {
+        long long completed = 0;
+        int makespan = 0;
+        double cpu_utilization = 0; // busy time / makespan; above 100% on several CPUs
+        double throughput = 0;
+        Summary waiting;
+        Summary turnaround;
+        Summary response;
+        long long responses = 0; // completions that reported a response time
+    };
+
+private:
+    struct Metric {
+        RunningStats stats;
+        QuantileSketch sketch;
+
+        void add(int value) {
+            stats.add(value);
+            sketch.add(value);
+        }
+
+        Summary summarize() const {
+            Summary s;
+            s.mean = stats.mean();
+            s.stddev = stats.stddev();
+            s.min = stats.min();
+            s.max = stats.max();
+            s.p50 = sketch.quantile(0.50);
+            s.p90 = sketch.quantile(0.90);
+            s.p99 = sketch.quantile(0.99);
+            return s;
+        }
+    };
+
+    Metric waiting;
+    Metric turnaround;
+    Metric response;
+    long long responses = 0;
+    long long completed = 0;
+    long long busy_time = 0;
+    int makespan = 0;
+
+public:
+    void add(const CompletionEvent& event) {
+        int turnaround_time = event.completion_time - event.arrival_time;
+        int waiting_time = turnaround_time - event.burst_time;
+
+        waiting.add(waiting_time);
+        turnaround.add(turnaround_time);
+        if (event.response_time >= 0) {
+            response.add(event.response_time);
+            responses++;
+        }
+        completed++;
+        busy_time += event.burst_time;
+        makespan = std::max(makespan, event.completion_time);
+    }
+
+    // Any finished process record with pid, arrival, burst and completion
+    // times, e.g. what a scheduler hands to its on_complete sink
+    template <typename ProcessRecord>
+    void add(const ProcessRecord& p, int response_time = -1) {
+        add(CompletionEvent{p.pid, p.arrival_time, p.burst_time, p.completion_time, response_time});
+    }
+
+    long long size() const { return completed; }
+
+    Snapshot snapshot() const {
+        Snapshot s;
+        s.completed = completed;
+        s.makespan = makespan;
+        if (makespan > 0) {
+            s.cpu_utilization = static_cast<double>(busy_time) / makespan * 100.0;
+            s.throughput = static_cast<double>(completed) / makespan;
+        }
+        s.waiting = waiting.summarize();
+        s.turnaround = turnaround.summarize();
+        s.response = response.summarize();
+        s.responses = responses;
+        return s;
+    }
+
+    static void display(const Snapshot& s) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "\n=== ONLINE SCHEDULING METRICS (" << s.completed << " completed) ===\n";
+        std::cout << "CPU Utilization: " << s.cpu_utilization << "%\n";
+        std::cout << "Throughput: " << s.throughput << " processes/unit time\n";
+        std::cout << std::left << std::setw(12) << "Metric" << std::right
+                  << std::setw(10) << "mean" << std::setw(10) << "stddev" << std::setw(8) << "min"
+                  << std::setw(8) << "p50" << std::setw(8) << "p90" << std::setw(8) << "p99"
+                  << std::setw(8) << "max" << "\n";
+        const std::pair<const char*, const Summary*> rows[] = {
+            {"Waiting", &s.waiting}, {"Turnaround", &s.turnaround}, {"Response", &s.response},
+        };
+        for (const auto& row : rows) {
+            // Response time is only known when the source reported dispatches
+            if (row.second == &s.response && s.responses == 0) continue;
+            const Summary& m = *row.second;
+            std::cout << std::left << std::setw(12) << row.first << std::right
+                      << std::setw(10) << m.mean << std::setw(10) << m.stddev << std::setw(8) << m.min
+                      << std::setw(8) << m.p50 << std::setw(8) << m.p90 << std::setw(8) << m.p99
+                      << std::setw(8) << m.max << "\n";
+        }
+    }
+};
+
+// MetricsAccumulator behind a mutex: record() and snapshot() may be called
+// from different threads
+class OnlineMetrics {
+public:
+    using Summary = MetricsAccumulator::Summary;
+    using Snapshot = MetricsAccumulator::Snapshot;
+
+private:
+    mutable std::mutex mtx;
+    MetricsAccumulator metrics;
+
+public:
+    void record(const CompletionEvent& event) {
+        std::lock_guard<std::mutex> lock(mtx);
+        metrics.add(event);
+    }
+
+    template <typename ProcessRecord>
+    void record(const ProcessRecord& p, int response_time = -1) {
+        std::lock_guard<std::mutex> lock(mtx);
+        metrics.add(p, response_time);
+    }
+
+    Snapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return metrics.snapshot();
+    }
+
+    static void display(const Snapshot& s) { MetricsAccumulator::display(s); }
+};
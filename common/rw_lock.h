@@ -0,0 +1,218 @@
+/*
+ * Read-mostly locking: a reader-biased reader-writer lock and a seqlock.
+ *
+ * std::shared_mutex keeps one reader count, so every lock_shared() and
+ * unlock_shared() writes the same cache line and readers on different CPUs
+ * slow each other down. ReaderBiasedRWLock spreads readers over per-thread
+ * slots, each on its own cache line. A reader only writes its own slot and
+ * reads the writer flag, which stays shared in every cache while no writer
+ * is around. A writer raises the flag (new readers then step back and wait,
+ * so writers are not starved) and waits for every slot to drain. Waiting
+ * readers sleep on the flag with a futex on Linux, a condition variable
+ * elsewhere. The method names match std::shared_mutex, so std::shared_lock
+ * and std::unique_lock work with it.
+ *
+ * SeqLock<T> is for small trivially copyable data. Readers take no lock and
+ * write no shared memory at all: they copy the value and retry if a writer
+ * ran in the meantime.
+ */
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include "spin_wait.h"
+
+namespace rw_lock_detail {
+
+// Spin while other CPUs can make progress for us, otherwise yield at once
+inline void backOff(int& rounds) {
+    static const int spin_limit = spin_wait::spinningHelps() ? 64 : 0;
+    if (rounds++ < spin_limit) {
+        spin_wait::cpuRelax();
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace rw_lock_detail
+
+class ReaderBiasedRWLock {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t READER_SLOTS = 64;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<int> readers{0};
+    };
+
+    Slot slots[READER_SLOTS];
+    alignas(CACHE_LINE_SIZE) std::atomic<int> writer{0}; // 1 while a writer is waiting or inside
+    std::atomic<int> sleeping_readers{0};
+    std::mutex writer_mtx; // queues writers behind each other
+    spin_wait::Futex futex; // readers sleep on 'writer'
+
+    // Threads get slots round-robin, so up to READER_SLOTS readers never share one
+    static size_t mySlot() {
+        static std::atomic<size_t> next_slot{0};
+        static thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % READER_SLOTS;
+        return slot;
+    }
+
+    void waitForWriter() {
+        sleeping_readers.fetch_add(1);
+        while (writer.load() != 0) futex.wait(writer, 1);
+        sleeping_readers.fetch_sub(1);
+    }
+
+public:
+    ReaderBiasedRWLock() = default;
+    ReaderBiasedRWLock(const ReaderBiasedRWLock&) = delete;
+    ReaderBiasedRWLock& operator=(const ReaderBiasedRWLock&) = delete;
+
+    void lock_shared() {
+        std::atomic<int>& mine = slots[mySlot()].readers;
+        for (;;) {
+            // Announce first, then look. lock() raises the flag before it
+            // scans the slots, so either we see the flag and back out or
+            // the writer sees our count and waits for it
+            mine.fetch_add(1);
+            if (writer.load() == 0) return;
+            mine.fetch_sub(1);
+            int rounds = 0;
+            while (writer.load(std::memory_order_relaxed) != 0 && rounds < 64) {
+                rw_lock_detail::backOff(rounds);
+            }
+            if (writer.load() != 0) waitForWriter();
+        }
+    }
+
+    bool try_lock_shared() {
+        std::atomic<int>& mine = slots[mySlot()].readers;
+        mine.fetch_add(1);
+        if (writer.load() == 0) return true;
+        mine.fetch_sub(1);
+        return false;
+    }
+
+    void unlock_shared() { slots[mySlot()].readers.fetch_sub(1, std::memory_order_release); }
+
+    void lock() {
+        writer_mtx.lock();
+        writer.store(1);
+        // seq_cst, not acquire: the scan must not be ordered before the flag
+        // store, or a reader could pass its flag check while we read its
+        // slot as empty
+        for (Slot& slot : slots) {
+            int rounds = 0;
+            while (slot.readers.load() != 0) {
+                rw_lock_detail::backOff(rounds);
+            }
+        }
+    }
+
+    bool try_lock() {
+        if (!writer_mtx.try_lock()) return false;
+        writer.store(1);
+        for (Slot& slot : slots) {
+            if (slot.readers.load() != 0) {
+                unlock();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void unlock() {
+        writer.store(0);
+        if (sleeping_readers.load() > 0) futex.wake(writer, INT_MAX);
+        writer_mtx.unlock();
+    }
+};
+
+// Sequence lock for small trivially copyable values. The sequence number is
+// odd while a write is in progress; a reader that saw it change retries.
+// The value is kept in relaxed atomic words so that a read racing with a
+// write is a retry, not undefined behaviour.
+template <typename T>
+class SeqLock {
+private:
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+    using Word = unsigned long;
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+
+    std::atomic<unsigned> sequence{0};
+    std::atomic<Word> words[WORDS];
+
+    void copyOut(T& out) const {
+        Word buffer[WORDS];
+        for (size_t i = 0; i < WORDS; i++) buffer[i] = words[i].load(std::memory_order_relaxed);
+        std::memcpy(&out, buffer, sizeof(T));
+    }
+
+    void copyIn(const T& value) {
+        Word buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; i++) words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+
+    // Writers exclude each other by moving the sequence from even to odd
+    unsigned beginWrite() {
+        int rounds = 0;
+        unsigned seq = sequence.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((seq & 1) == 0 &&
+                sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+                std::atomic_thread_fence(std::memory_order_release);
+                return seq;
+            }
+            rw_lock_detail::backOff(rounds);
+            seq = sequence.load(std::memory_order_relaxed);
+        }
+    }
+
+    void endWrite(unsigned seq) { sequence.store(seq + 2, std::memory_order_release); }
+
+public:
+    explicit SeqLock(const T& initial = T()) { copyIn(initial); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    T load() const {
+        T value;
+        int rounds = 0;
+        for (;;) {
+            unsigned before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                copyOut(value);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) return value;
+            }
+            rw_lock_detail::backOff(rounds);
+        }
+    }
+
+    void store(const T& value) {
+        unsigned seq = beginWrite();
+        copyIn(value);
+        endWrite(seq);
+    }
+
+    // Read-modify-write under the write side; f gets a T& to change in place
+    template <typename F>
+    void update(F f) {
+        unsigned seq = beginWrite();
+        T value;
+        copyOut(value);
+        f(value);
+        copyIn(value);
+        endWrite(seq);
+    }
+};
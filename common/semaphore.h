@@ -0,0 +1,106 @@
+/*
+ * Counting semaphore shared by the synchronization labs (Lab5, Lab6).
+ *
+ * The permit count lives in one atomic int. acquire() takes a permit with
+ * a CAS when one is available and release() is a single fetch_add, so the
+ * uncontended path never takes a lock or makes a system call. A thread that
+ * finds no permit spins for a while (the spin budget adapts to whether
+ * spinning has been paying off) and then sleeps on the counter itself with
+ * a futex on Linux, or a condition variable elsewhere. release() only
+ * issues a wake when a thread is actually asleep.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include "spin_wait.h"
+
+class Semaphore {
+private:
+    static constexpr int MIN_SPIN = 16;
+    static constexpr int MAX_SPIN = 4096;
+
+    std::atomic<int> count;       // available permits; also the futex word
+    std::atomic<int> sleepers{0}; // threads parked, or about to park, in acquireSlow()
+    std::atomic<int> spin_limit{256};
+    spin_wait::Futex futex;
+
+    bool tryTake() {
+        int c = count.load(std::memory_order_relaxed);
+        while (c > 0) {
+            if (count.compare_exchange_weak(c, c - 1, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Spin up to the current budget. A spin that ends in a permit lets the
+    // next one run longer; one that fails halves the budget, so waiters on
+    // long holds quickly stop burning CPU.
+    bool spinTake() {
+        if (!spin_wait::spinningHelps()) return false;
+        int limit = spin_limit.load(std::memory_order_relaxed);
+        for (int i = 0; i < limit; i++) {
+            if (count.load(std::memory_order_relaxed) > 0 && tryTake()) {
+                if (limit < MAX_SPIN) spin_limit.store(limit * 2, std::memory_order_relaxed);
+                return true;
+            }
+            spin_wait::cpuRelax();
+        }
+        if (limit > MIN_SPIN) spin_limit.store(limit / 2, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Slow path shared by acquire() and try_acquire_until(). We register as
+    // a sleeper before the last tryTake(), and release() raises the count
+    // before it reads sleepers, so a release either finds us registered or
+    // leaves a permit for that last try (see spin_wait.h).
+    bool acquireSlow(const std::chrono::steady_clock::time_point* deadline) {
+        if (spinTake()) return true;
+        sleepers.fetch_add(1);
+        bool acquired = tryTake();
+        while (!acquired) {
+            bool timed_out = !futex.wait(count, 0, deadline);
+            acquired = tryTake();
+            if (timed_out) break;
+        }
+        sleepers.fetch_sub(1);
+        return acquired;
+    }
+
+public:
+    explicit Semaphore(int initial_count) : count(initial_count) {}
+
+    Semaphore(const Semaphore&) = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+    void acquire() {
+        if (!tryTake()) acquireSlow(nullptr);
+    }
+
+    // Returns n permits at once and wakes up to n sleepers
+    void release(int n = 1) {
+        count.fetch_add(n);
+        if (sleepers.load() > 0) futex.wake(count, n);
+    }
+
+    bool try_acquire() { return tryTake(); }
+
+    template <typename Rep, typename Period>
+    bool try_acquire_for(const std::chrono::duration<Rep, Period>& timeout) {
+        return try_acquire_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename Clock, typename Duration>
+    bool try_acquire_until(const std::chrono::time_point<Clock, Duration>& abs_time) {
+        if (tryTake()) return true;
+        // Futex timeouts are relative, so any clock is mapped onto steady_clock
+        auto deadline = std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(abs_time - Clock::now());
+        return acquireSlow(&deadline);
+    }
+
+    int available() const { return count.load(std::memory_order_relaxed); }
+};
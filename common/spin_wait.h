@@ -0,0 +1,113 @@
+/*
+ * Spinning and sleeping building blocks for the headers in common/ and the
+ * Lab4/Lab5 schedulers.
+ *
+ * cpuRelax() goes in the body of a spin loop: it tells the CPU we are
+ * waiting, which saves power and lets a sibling hyperthread run.
+ * spinningHelps() is false on a single-CPU machine, where the thread we
+ * wait for cannot make progress while we spin, so callers skip straight
+ * to yielding or sleeping.
+ *
+ * Futex sleeps on an atomic<int> until it no longer holds an expected
+ * value, and wakes such sleepers. On Linux it is the futex system call and
+ * has no state of its own; elsewhere it is a mutex and a condition
+ * variable, so keep one Futex per waited-on word.
+ *
+ * Every user pairs a sleep with a wake the same way: the sleeper announces
+ * itself (a waiter count, its reader slot) and then re-checks the
+ * condition, while the waker changes the condition and then looks for
+ * sleepers, all with seq_cst operations. With both sides storing before
+ * they load, at least one of them sees the other's store, so a sleeper
+ * cannot miss its wakeup.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <thread>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <ctime>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace spin_wait {
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+inline bool spinningHelps() {
+    static const bool multi_cpu = std::thread::hardware_concurrency() > 1;
+    return multi_cpu;
+}
+
+class Futex {
+private:
+#if !defined(__linux__)
+    std::mutex mtx;
+    std::condition_variable cv;
+#endif
+
+public:
+    Futex() = default;
+    Futex(const Futex&) = delete;
+    Futex& operator=(const Futex&) = delete;
+
+    // Sleep while 'word' holds 'expected'. Returns false once 'deadline'
+    // passes; nullptr waits forever. Spurious returns are fine, callers
+    // re-check their condition.
+    bool wait(std::atomic<int>& word, int expected,
+              const std::chrono::steady_clock::time_point* deadline = nullptr) {
+#if defined(__linux__)
+        struct timespec timeout;
+        struct timespec* timeout_ptr = nullptr;
+        if (deadline) {
+            auto left = *deadline - std::chrono::steady_clock::now();
+            if (left <= std::chrono::steady_clock::duration::zero()) return false;
+            auto secs = std::chrono::duration_cast<std::chrono::seconds>(left);
+            timeout.tv_sec = static_cast<time_t>(secs.count());
+            timeout.tv_nsec = static_cast<long>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(left - secs).count());
+            timeout_ptr = &timeout;
+        }
+        long rc = syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT_PRIVATE, expected,
+                          timeout_ptr, nullptr, 0);
+        return !(rc == -1 && errno == ETIMEDOUT);
+#else
+        std::unique_lock<std::mutex> lock(mtx);
+        auto changed = [&] { return word.load() != expected; };
+        if (!deadline) {
+            cv.wait(lock, changed);
+            return true;
+        }
+        return cv.wait_until(lock, *deadline, changed);
+#endif
+    }
+
+    // Wake up to n threads sleeping on 'word'; INT_MAX wakes them all
+    void wake(std::atomic<int>& word, int n) {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE_PRIVATE, n, nullptr, nullptr, 0);
+#else
+        (void)word;
+        { std::lock_guard<std::mutex> lock(mtx); }
+        if (n == 1) cv.notify_one();
+        else cv.notify_all();
+#endif
+    }
+};
+
+} // namespace spin_wait
@@ -0,0 +1,145 @@
+/*
+ * Bounded single-producer single-consumer ring for pipeline stages.
+ *
+ * Exactly one thread may push and exactly one other thread may pop. Each
+ * side owns its index on its own cache line and keeps a private copy of the
+ * other side's index, so a push or pop normally touches no shared line at
+ * all: the copy is refreshed only when it says the ring looks full (for the
+ * producer) or empty (for the consumer). Every operation finishes in a
+ * bounded number of steps; waiting for room or items is left to the caller.
+ * push_n()/pop_n() move a whole batch with a single index update.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename T>
+class SPSCQueue {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Slot {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T* item() { return reinterpret_cast<T*>(&storage); }
+    };
+
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+
+    // Consumer side
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    size_t cached_tail = 0;
+
+    // Producer side
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    size_t cached_head = 0;
+
+    // Room the producer can use without waiting for the consumer
+    size_t freeSlots(size_t t, size_t wanted) {
+        size_t free = capacity() - (t - cached_head);
+        if (free < wanted) {
+            cached_head = head.load(std::memory_order_acquire);
+            free = capacity() - (t - cached_head);
+        }
+        return free;
+    }
+
+    size_t readySlots(size_t h, size_t wanted) {
+        size_t ready = cached_tail - h;
+        if (ready < wanted) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            ready = cached_tail - h;
+        }
+        return ready;
+    }
+
+public:
+    // Capacity is rounded up to a power of two
+    explicit SPSCQueue(size_t capacity)
+        : mask(roundUpPow2(capacity) - 1), slots(new Slot[mask + 1]) {}
+
+    // Destroys items still queued; neither side may be using the queue
+    ~SPSCQueue() {
+        size_t t = tail.load();
+        for (size_t h = head.load(); h != t; h++) {
+            slots[h & mask].item()->~T();
+        }
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // Producer only
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (freeSlots(t, 1) == 0) return false;
+        new (slots[t & mask].item()) T(std::forward<Args>(args)...);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item) { return try_emplace(item); }
+    bool try_push(T&& item) { return try_emplace(std::move(item)); }
+
+    // Producer only: copies up to n items from 'first' (wrap it in
+    // std::make_move_iterator to move them) and returns how many fit
+    template <typename InputIt>
+    size_t push_n(InputIt first, size_t n) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t count = std::min(n, freeSlots(t, n));
+        for (size_t i = 0; i < count; i++, ++first) {
+            new (slots[(t + i) & mask].item()) T(*first);
+        }
+        if (count) tail.store(t + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer only
+    bool try_pop(T& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (readySlots(h, 1) == 0) return false;
+        T* item = slots[h & mask].item();
+        out = std::move(*item);
+        item->~T();
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: moves up to max_items items to 'out' and returns how many
+    template <typename OutputIt>
+    size_t pop_n(OutputIt out, size_t max_items) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t count = std::min(max_items, readySlots(h, max_items));
+        for (size_t i = 0; i < count; i++, ++out) {
+            T* item = slots[(h + i) & mask].item();
+            *out = std::move(*item);
+            item->~T();
+        }
+        if (count) head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Exact from either side's own thread only when the other side is idle
+    size_t size() const {
+        size_t h = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - h;
+    }
+
+    bool empty() const { return size() == 0; }
+};
@@ -0,0 +1,329 @@
+/*
+ * Work-stealing thread pool.
+ *
+ * Each worker owns a deque of tasks behind its own mutex, so workers on
+ * different deques never contend. A worker runs tasks from its own deque
+ * first and only then steals the oldest task from another worker. Tasks a
+ * worker spawns go to the back of its own deque and run LIFO (the data is
+ * still in cache); tasks from outside the pool are dealt round-robin to
+ * the front of the deques, so each worker takes them oldest first. A
+ * worker that runs out of tasks yields a few times, then sleeps on an
+ * EventCount (common/mpmc_queue.h); submitting only makes a system call
+ * when a worker is asleep.
+ *
+ * Tasks are move-only and stored in a 64-byte Task object; callables up to
+ * 48 bytes live inside it without a heap allocation. submit() returns a
+ * std::future; post() is fire-and-forget for callables that do not throw.
+ * shutdown() (and the destructor) runs every queued task before joining,
+ * including tasks those tasks submit.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "mpmc_queue.h"
+
+// Move-only type-erased void() callable with inline storage
+class Task {
+private:
+    static constexpr size_t INLINE_SIZE = 48;
+
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* from, void* to); // also destroys 'from'
+        void (*destroy)(void* storage);
+    };
+
+    template <typename F>
+    struct InlineOps {
+        static void invoke(void* p) { (*static_cast<F*>(p))(); }
+        static void move(void* from, void* to) {
+            new (to) F(std::move(*static_cast<F*>(from)));
+            static_cast<F*>(from)->~F();
+        }
+        static void destroy(void* p) { static_cast<F*>(p)->~F(); }
+        static constexpr Ops table{invoke, move, destroy};
+    };
+
+    // Too big for the buffer: the buffer holds an owning pointer instead
+    template <typename F>
+    struct HeapOps {
+        static F*& target(void* p) { return *static_cast<F**>(p); }
+        static void invoke(void* p) { (*target(p))(); }
+        static void move(void* from, void* to) { new (to) F*(target(from)); }
+        static void destroy(void* p) { delete target(p); }
+        static constexpr Ops table{invoke, move, destroy};
+    };
+
+    template <typename F>
+    static constexpr bool fitsInline() {
+        return sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<F>::value;
+    }
+
+    alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+    const Ops* ops = nullptr;
+
+    void reset() {
+        if (ops) ops->destroy(storage);
+        ops = nullptr;
+    }
+
+public:
+    Task() = default;
+
+    template <typename F, typename Fn = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same<Fn, Task>::value>>
+    Task(F&& f) {
+        if constexpr (fitsInline<Fn>()) {
+            new (storage) Fn(std::forward<F>(f));
+            ops = &InlineOps<Fn>::table;
+        } else {
+            new (storage) Fn*(new Fn(std::forward<F>(f)));
+            ops = &HeapOps<Fn>::table;
+        }
+    }
+
+    Task(Task&& other) noexcept : ops(other.ops) {
+        if (ops) ops->move(other.storage, storage);
+        other.ops = nullptr;
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ops = other.ops;
+            if (ops) ops->move(other.storage, storage);
+            other.ops = nullptr;
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    void operator()() { ops->invoke(storage); }
+};
+
+// Growable ring of tasks usable from both ends; no allocation once it has
+// reached its working size
+class TaskDeque {
+private:
+    std::vector<Task> ring = std::vector<Task>(16);
+    size_t head = 0;
+    size_t count = 0;
+
+    size_t slot(size_t i) const { return (head + i) & (ring.size() - 1); }
+
+    void growIfFull() {
+        if (count < ring.size()) return;
+        std::vector<Task> bigger(ring.size() * 2);
+        for (size_t i = 0; i < count; i++) bigger[i] = std::move(ring[slot(i)]);
+        ring.swap(bigger);
+        head = 0;
+    }
+
+public:
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void push_back(Task&& task) {
+        growIfFull();
+        ring[slot(count)] = std::move(task);
+        count++;
+    }
+
+    void push_front(Task&& task) {
+        growIfFull();
+        head = (head - 1) & (ring.size() - 1);
+        ring[head] = std::move(task);
+        count++;
+    }
+
+    Task pop_back() {
+        count--;
+        return std::move(ring[slot(count)]);
+    }
+
+    Task pop_front() {
+        Task task = std::move(ring[head]);
+        head = (head + 1) & (ring.size() - 1);
+        count--;
+        return task;
+    }
+};
+
+class ThreadPool {
+private:
+    static constexpr int IDLE_YIELDS = 16;
+
+    struct alignas(64) Worker {
+        std::mutex mtx;
+        TaskDeque tasks;
+        std::atomic<size_t> size{0}; // tasks.size(), readable without the lock
+    };
+
+    struct Identity {
+        const ThreadPool* pool = nullptr;
+        size_t index = 0;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> next_worker{0}; // round-robin target for outside submits
+    std::atomic<bool> stopping{false};
+    std::mutex shutdown_mtx;
+    EventCount idle;
+
+    static Identity& identity() {
+        static thread_local Identity self;
+        return self;
+    }
+
+    void enqueue(Task&& task) {
+        const Identity& self = identity();
+        bool own_worker = self.pool == this;
+        if (!own_worker && stopping.load(std::memory_order_relaxed)) {
+            throw std::runtime_error("ThreadPool: submit after shutdown");
+        }
+        Worker& w = own_worker ? *workers[self.index]
+                               : *workers[next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size()];
+        {
+            std::lock_guard<std::mutex> lock(w.mtx);
+            if (own_worker) w.tasks.push_back(std::move(task));
+            else w.tasks.push_front(std::move(task));
+            w.size.store(w.tasks.size(), std::memory_order_relaxed);
+        }
+        idle.notify();
+    }
+
+    bool hasWork() const {
+        for (auto& w : workers) {
+            if (w->size.load() > 0) return true;
+        }
+        return false;
+    }
+
+    // Own deque from the back, otherwise the oldest task of the next busy worker
+    bool takeTask(size_t index, Task& out) {
+        for (size_t i = 0; i < workers.size(); i++) {
+            Worker& w = *workers[(index + i) % workers.size()];
+            if (w.size.load(std::memory_order_relaxed) == 0) continue;
+            std::lock_guard<std::mutex> lock(w.mtx);
+            if (w.tasks.empty()) continue;
+            out = i == 0 ? w.tasks.pop_back() : w.tasks.pop_front();
+            w.size.store(w.tasks.size(), std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index) {
+        identity() = Identity{this, index};
+        Task task;
+        bool slept = false;
+        int idle_rounds = 0;
+        for (;;) {
+            if (takeTask(index, task)) {
+                // Notifications that arrived while our wakeup was pending were
+                // folded into it, so pass it on while there is more work
+                if (slept && hasWork()) idle.notify();
+                slept = false;
+                idle_rounds = 0;
+                task();
+                task = Task();
+                continue;
+            }
+            // Yield a few times first: on a busy machine the submitter usually
+            // gets to run and queue more before we would have fallen asleep
+            if (idle_rounds++ < IDLE_YIELDS) {
+                std::this_thread::yield();
+                continue;
+            }
+            idle_rounds = 0;
+            int epoch = idle.prepareWait();
+            if (hasWork()) {
+                idle.cancelWait();
+                continue;
+            }
+            if (stopping.load()) {
+                idle.cancelWait();
+                return;
+            }
+            idle.wait(epoch);
+            slept = true;
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency()) {
+        if (thread_count == 0) thread_count = 1;
+        for (size_t i = 0; i < thread_count; i++) {
+            workers.emplace_back(new Worker);
+        }
+        for (size_t i = 0; i < thread_count; i++) {
+            threads.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ~ThreadPool() { shutdown(); }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Runs f(args...) on a worker; the future carries its result or exception
+    template <typename F, typename... Args>
+    auto submit(F&& f, Args&&... args)
+        -> std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> {
+        using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+        std::packaged_task<R()> task(
+            [f = std::forward<F>(f), args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                return std::apply(std::move(f), std::move(args));
+            });
+        std::future<R> result = task.get_future();
+        enqueue(Task(std::move(task)));
+        return result;
+    }
+
+    // No future and no shared state; f must not throw
+    template <typename F>
+    void post(F&& f) {
+        enqueue(Task(std::forward<F>(f)));
+    }
+
+    // Runs everything queued, then joins the workers. Safe to call twice;
+    // must not be called from a task. Submitting from outside the pool
+    // afterwards throws, but tasks may keep submitting until the pool drains.
+    void shutdown() {
+        std::lock_guard<std::mutex> lock(shutdown_mtx);
+        if (threads.empty()) return;
+        stopping.store(true);
+        idle.notify(true);
+        for (auto& t : threads) t.join();
+        threads.clear();
+        // A submit that raced with stopping may have landed after the workers left
+        for (auto& w : workers) {
+            while (!w->tasks.empty()) {
+                Task task = w->tasks.pop_front();
+                w->size.store(w->tasks.size());
+                task();
+            }
+        }
+    }
+
+    size_t size() const { return workers.size(); }
+};